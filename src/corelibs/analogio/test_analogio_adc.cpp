@@ -22,6 +22,12 @@
  *      |
  *      GND (0V)
  * 
+ * The noise test cases take ADC_NOISE_SAMPLES samples per pin and resolution and
+ * report mean, standard deviation, the effective number of bits and a histogram of
+ * the codes. The statistics are streamed (Welford's algorithm) and the histogram
+ * has ADC_NOISE_HISTOGRAM_BINS bins centred on the mean of a short warm-up series,
+ * so no sample buffer is needed. On the VREF and GND pins the signal sits at the
+ * end of the range and the noise is clipped, the divider pin gives the noise floor.
  */
 
 // std includes
@@ -35,8 +41,13 @@
 // defines
 #define TRACE_OUTPUT
 #define TOLERANCE 100
+#define ADC_NOISE_SAMPLES           4096
+#define ADC_NOISE_WARMUP_SAMPLES    64
+#define ADC_NOISE_HISTOGRAM_BINS    15   // odd, the outer bins collect the tails
+#define ADC_NOISE_MAX_BITS_LOST     4    // ENOB below the resolution
 
 // variables
+static const int adc_noise_resolutions[] = {8, 10, 12};
 
 /**
  * @brief Validates if the actual ADC value is within the acceptable range of the expected value.
@@ -49,6 +60,82 @@ static bool validate_adc_raw_value(int expected_value, int actual_value) {
     return (expected_value - TOLERANCE) < actual_value && (expected_value + TOLERANCE) > actual_value;
 }
 
+/**
+ * @brief Effective number of bits for the measured noise.
+ *
+ * The quantization noise of an ideal converter has a standard deviation of
+ * 1/sqrt(12) LSB, lower noise cannot be resolved and yields the full resolution.
+ */
+static double adc_enob(int resolution, double stddev) {
+    double ratio = stddev * sqrt(12.0);
+    return ratio > 1.0 ? resolution - log2(ratio) : (double)resolution;
+}
+
+/**
+ * @brief Sample a pin ADC_NOISE_SAMPLES times per resolution and report its noise statistics.
+ *
+ * @param pin The analog input pin.
+ * @param name The pin name for the report.
+ * @param full_scale_ratio The expected value as a ratio of the full scale (0.0 to 1.0).
+ */
+static void adc_noise_statistics(uint8_t pin, const char *name, double full_scale_ratio) {
+    analogReference(DEFAULT);
+
+    for (size_t i = 0; i < sizeof(adc_noise_resolutions) / sizeof(adc_noise_resolutions[0]); i++) {
+        int resolution = adc_noise_resolutions[i];
+        int max_value = (1 << resolution) - 1;
+        uint32_t histogram[ADC_NOISE_HISTOGRAM_BINS] = {0};
+        RunningStats warmup;
+        RunningStats stats;
+
+        analogReadResolution(resolution);
+        for (uint16_t n = 0; n < ADC_NOISE_WARMUP_SAMPLES; n++) {
+            warmup.add(analogRead(pin));
+        }
+        int first_code = (int)(warmup.mean() + 0.5) - ADC_NOISE_HISTOGRAM_BINS / 2;
+
+        for (uint16_t n = 0; n < ADC_NOISE_SAMPLES; n++) {
+            int value = analogRead(pin);
+            stats.add(value);
+
+            int bin = value - first_code;
+            if (bin < 0) {
+                bin = 0;
+            } else if (bin >= ADC_NOISE_HISTOGRAM_BINS) {
+                bin = ADC_NOISE_HISTOGRAM_BINS - 1;
+            }
+            histogram[bin]++;
+        }
+
+        double enob = adc_enob(resolution, stats.stddev());
+
+#ifdef TRACE_OUTPUT
+        Serial.print("\n");
+        Serial.print(name);
+        Serial.print(" pin, ");
+        Serial.print(resolution);
+        Serial.println(" bit");
+        stats.print("Code", "LSB");
+        Serial.print("ENOB: ");
+        Serial.println(enob, 2);
+        for (int bin = 0; bin < ADC_NOISE_HISTOGRAM_BINS; bin++) {
+            if (histogram[bin] == 0) {
+                continue;
+            }
+            Serial.print(bin == 0 ? "<=" : (bin == ADC_NOISE_HISTOGRAM_BINS - 1 ? ">=" : "  "));
+            Serial.print(first_code + bin);
+            Serial.print("\t");
+            Serial.println(histogram[bin]);
+        }
+#endif
+
+        TEST_ASSERT_EQUAL_UINT32(ADC_NOISE_SAMPLES, stats.count());
+        TEST_ASSERT_TRUE_MESSAGE(validate_adc_raw_value((int)(max_value * full_scale_ratio), (int)stats.mean()),
+                                 "ADC mean value is not within the expected range");
+        TEST_ASSERT_TRUE_MESSAGE(enob >= resolution - ADC_NOISE_MAX_BITS_LOST, "ADC noise exceeds the expected floor");
+    }
+}
+
 /**
  * @brief Suite setup function, runs before test suite execution begins.
  */
@@ -155,6 +242,42 @@ TEST_IFX(analogio_adc, test_adc_read_default_gnd_pin)
 
 #endif // TEST_PIN_ANALOG_IO_GND 
 
+#ifdef TEST_PIN_ANALOG_IO_VREF
+
+/**
+ * @brief Report the noise statistics of the pin that is connected to VDDA per resolution.
+ */
+TEST_IFX(analogio_adc, test_adc_noise_vref_pin)
+{
+    adc_noise_statistics(TEST_PIN_ANALOG_IO_VREF, "VREF", 1.0);
+}
+
+#endif // TEST_PIN_ANALOG_IO_VREF
+
+#ifdef TEST_PIN_ANALOG_IO_DIVIDER
+
+/**
+ * @brief Report the noise statistics of the pin that is connected to voltage divider per resolution.
+ */
+TEST_IFX(analogio_adc, test_adc_noise_divider_pin)
+{
+    adc_noise_statistics(TEST_PIN_ANALOG_IO_DIVIDER, "Divider", 0.5);
+}
+
+#endif // TEST_PIN_ANALOG_IO_DIVIDER
+
+#ifdef TEST_PIN_ANALOG_IO_GND
+
+/**
+ * @brief Report the noise statistics of the pin that is connected to ground per resolution.
+ */
+TEST_IFX(analogio_adc, test_adc_noise_gnd_pin)
+{
+    adc_noise_statistics(TEST_PIN_ANALOG_IO_GND, "GND", 0.0);
+}
+
+#endif // TEST_PIN_ANALOG_IO_GND
+
 
 /**
  * @brief Bundle all tests to be executed for this test group.
@@ -175,5 +298,17 @@ TEST_GROUP_RUNNER(analogio_adc)
     RUN_TEST_CASE(analogio_adc, test_adc_read_default_gnd_pin);
 #endif
 
+#ifdef TEST_PIN_ANALOG_IO_VREF
+    RUN_TEST_CASE(analogio_adc, test_adc_noise_vref_pin);
+#endif
+
+#ifdef TEST_PIN_ANALOG_IO_DIVIDER
+    RUN_TEST_CASE(analogio_adc, test_adc_noise_divider_pin);
+#endif
+
+#ifdef TEST_PIN_ANALOG_IO_GND
+    RUN_TEST_CASE(analogio_adc, test_adc_noise_gnd_pin);
+#endif
+
     analogio_adc_suite_teardown();
 }
@@ -0,0 +1,216 @@
+/**
+ * @brief test_analogio_adc_benchmark.cpp
+ *
+ * @details This test measures the sampling performance of the ADC.
+ * only one board is needed with
+ *
+ * TEST_PIN_ANALOG_IO_DIVIDER pin connected to voltage divider (see test_analogio_adc.cpp).
+ *
+ * The test cases:
+ * - Maximum sample rate: ADC_BENCH_SAMPLES back-to-back analogRead() calls for every
+ *   resolution in {8, 10, 12}, reported in samples/s and µs per sample.
+ * - Block sampling: ADC_BLOCK_SAMPLES samples are captured into a buffer together with
+ *   their micros() timestamps, paced by an absolute schedule at every rate of
+ *   adc_block_rates_hz. The jitter is reported as the statistics of the intervals
+ *   between samples and of the deviation of the timestamps from the schedule.
+ *   Rates above ADC_BLOCK_MAX_LOAD of the measured maximum rate are skipped.
+ *
+ * The block sampling is paced by software: the deviation includes the conversion
+ * time variation as well as the interrupts served meanwhile.
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define ADC_BENCH_PIN               TEST_PIN_ANALOG_IO_DIVIDER
+#define ADC_BENCH_SAMPLES           1000
+#define ADC_BLOCK_SAMPLES           256
+#define ADC_BLOCK_MAX_LOAD          0.8     // share of the maximum rate
+#define ADC_BLOCK_MAX_PERIOD_ERROR  0.01    // mean interval vs. schedule
+#define ADC_BLOCK_MAX_JITTER        0.25    // interval standard deviation vs. period
+
+// variables
+static const uint8_t adc_bench_resolutions[] = {8, 10, 12};
+static const uint32_t adc_block_rates_hz[] = {100, 1000, 5000, 10000};
+
+#define ADC_BENCH_RESOLUTIONS (sizeof(adc_bench_resolutions) / sizeof(adc_bench_resolutions[0]))
+#define ADC_BLOCK_RATES       (sizeof(adc_block_rates_hz) / sizeof(adc_block_rates_hz[0]))
+
+static double max_rate_hz[ADC_BENCH_RESOLUTIONS];
+static uint16_t block_values[ADC_BLOCK_SAMPLES];
+static uint32_t block_timestamps_us[ADC_BLOCK_SAMPLES];
+
+/**
+ * @brief Capture ADC_BLOCK_SAMPLES samples at the given rate.
+ *
+ * The sample n is taken at start + n * period, so that a late sample does not
+ * delay the following ones.
+ */
+static void adc_capture_block(uint32_t rate_hz) {
+    double period_us = (double)MICROSECONDS_PER_SECOND / rate_hz;
+
+    uint32_t start = micros();
+    for (uint16_t n = 0; n < ADC_BLOCK_SAMPLES; n++) {
+        uint32_t due = start + (uint32_t)(n * period_us);
+        while ((int32_t)(micros() - due) < 0) {
+        }
+        block_timestamps_us[n] = micros();
+        block_values[n] = analogRead(ADC_BENCH_PIN);
+    }
+
+    for (uint16_t n = 0; n < ADC_BLOCK_SAMPLES; n++) {
+        block_timestamps_us[n] -= start;
+    }
+}
+
+/**
+ * @brief Suite setup function, runs before test suite execution begins.
+ */
+static void analogio_adc_benchmark_suite_setup() {
+    analogReference(DEFAULT);
+}
+
+/**
+ * @brief Suite teardown function, runs after test suite execution is complete.
+ */
+static void analogio_adc_benchmark_suite_teardown() {
+}
+
+// Define test group name
+TEST_GROUP(analogio_adc_benchmark);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(analogio_adc_benchmark) {
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(analogio_adc_benchmark) {
+    analogReadResolution(TEST_ADC_RESOLUTION);
+}
+
+#ifdef TEST_PIN_ANALOG_IO_DIVIDER
+
+/**
+ * @brief Measure the maximum rate of back-to-back analogRead() calls per resolution.
+ */
+TEST_IFX(analogio_adc_benchmark, test_adc_max_sample_rate)
+{
+#ifdef TRACE_OUTPUT
+    Serial.println("\nresolution\tsamples/s\tus/sample");
+#endif
+    for (uint8_t i = 0; i < ADC_BENCH_RESOLUTIONS; i++) {
+        uint8_t resolution = adc_bench_resolutions[i];
+        int max_value = (1 << resolution) - 1;
+        int out_of_range = 0;
+
+        analogReadResolution(resolution);
+        analogRead(ADC_BENCH_PIN); // the first conversion may include the channel setup
+
+        uint32_t start = micros();
+        for (uint16_t n = 0; n < ADC_BENCH_SAMPLES; n++) {
+            int value = analogRead(ADC_BENCH_PIN);
+            if (value < 0 || value > max_value) {
+                out_of_range++;
+            }
+        }
+        uint32_t elapsed = micros() - start;
+        if (elapsed == 0) {
+            elapsed = 1;
+        }
+        max_rate_hz[i] = (double)ADC_BENCH_SAMPLES * MICROSECONDS_PER_SECOND / elapsed;
+
+#ifdef TRACE_OUTPUT
+        Serial.print(resolution);
+        Serial.print("\t\t");
+        Serial.print(max_rate_hz[i], 0);
+        Serial.print("\t\t");
+        Serial.println((double)elapsed / ADC_BENCH_SAMPLES, 2);
+#endif
+        TEST_ASSERT_EQUAL_INT_MESSAGE(0, out_of_range, "ADC value exceeds the resolution range");
+        TEST_ASSERT_TRUE(max_rate_hz[i] > 0);
+    }
+}
+
+/**
+ * @brief Capture blocks of timestamped samples at fixed rates and report the jitter.
+ */
+TEST_IFX(analogio_adc_benchmark, test_adc_block_sampling_jitter)
+{
+    analogReadResolution(TEST_ADC_RESOLUTION);
+
+    double max_rate = 0.0;
+    for (uint8_t i = 0; i < ADC_BENCH_RESOLUTIONS; i++) {
+        if (adc_bench_resolutions[i] == TEST_ADC_RESOLUTION || max_rate == 0.0) {
+            max_rate = max_rate_hz[i];
+        }
+    }
+
+    uint8_t captured = 0;
+    for (uint8_t r = 0; r < ADC_BLOCK_RATES; r++) {
+        uint32_t rate_hz = adc_block_rates_hz[r];
+        if (max_rate > 0.0 && rate_hz > max_rate * ADC_BLOCK_MAX_LOAD) {
+#ifdef TRACE_OUTPUT
+            Serial.print("\nBlock sampling at ");
+            Serial.print(rate_hz);
+            Serial.println(" Hz skipped, above the maximum sample rate");
+#endif
+            continue;
+        }
+
+        adc_capture_block(rate_hz);
+        captured++;
+
+        double period_us = (double)MICROSECONDS_PER_SECOND / rate_hz;
+        RunningStats intervals;
+        RunningStats deviation;
+        RunningStats values;
+        for (uint16_t n = 0; n < ADC_BLOCK_SAMPLES; n++) {
+            if (n > 0) {
+                intervals.add((double)(block_timestamps_us[n] - block_timestamps_us[n - 1]));
+            }
+            deviation.add((double)block_timestamps_us[n] - n * period_us);
+            values.add(block_values[n]);
+        }
+
+#ifdef TRACE_OUTPUT
+        Serial.print("\nBlock sampling at ");
+        Serial.print(rate_hz);
+        Serial.println(" Hz");
+        intervals.print("Sample interval", "us");
+        deviation.print("Deviation from schedule", "us");
+        values.print("Sample value", "LSB");
+#endif
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(period_us * ADC_BLOCK_MAX_PERIOD_ERROR, period_us, intervals.mean(),
+                                         "Mean sample interval off the requested rate");
+        TEST_ASSERT_TRUE_MESSAGE(intervals.stddev() <= period_us * ADC_BLOCK_MAX_JITTER, "Sample interval jitter too high");
+    }
+    TEST_ASSERT_GREATER_THAN_UINT8(0, captured);
+}
+
+#endif // TEST_PIN_ANALOG_IO_DIVIDER
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(analogio_adc_benchmark)
+{
+    analogio_adc_benchmark_suite_setup();
+
+#ifdef TEST_PIN_ANALOG_IO_DIVIDER
+    RUN_TEST_CASE(analogio_adc_benchmark, test_adc_max_sample_rate);
+    RUN_TEST_CASE(analogio_adc_benchmark, test_adc_block_sampling_jitter);
+#endif
+
+    analogio_adc_benchmark_suite_teardown();
+}
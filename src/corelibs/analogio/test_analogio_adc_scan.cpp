@@ -0,0 +1,258 @@
+/**
+ * @brief test_analogio_adc_scan.cpp
+ *
+ * @details This test measures the cost of scanning several ADC channels.
+ * only one board is needed with the analog pins of test_analogio_adc.cpp
+ * (TEST_PIN_ANALOG_IO_VREF, TEST_PIN_ANALOG_IO_DIVIDER, TEST_PIN_ANALOG_IO_GND)
+ * connected. TEST_PIN_ANALOG_IO_DAC_INPUT is scanned as well if configured, with
+ * TEST_PIN_ANALOG_IO_DAC driving it to half scale (see test_analogio_dac.cpp).
+ * At least two of the pins are needed.
+ *
+ * The test cases:
+ * - Settled values: every channel is read ADC_SCAN_SETTLED_SAMPLES times in a row,
+ *   the mean is the reference value of the channel. A second run of the same reads
+ *   without processing gives the time per sample, the single channel cost.
+ * - Scan throughput: ADC_SCAN_ROUNDS round-robin scans over all channels at full
+ *   speed, timed as a whole, give the scan time and the effective rate per channel.
+ *   A separate run times every sample, less the cost of a micros() pair, for the time
+ *   per sample of every channel.
+ * - Crosstalk: every channel is read right after every other channel. The deviation
+ *   from the settled value is the settling error caused by the charge left from the
+ *   previous channel, reported as a matrix in LSB.
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define ADC_SCAN_SETTLED_SAMPLES        256
+#define ADC_SCAN_ROUNDS                 1000
+#define ADC_SCAN_CROSSTALK_SAMPLES      64
+#define ADC_SCAN_MAX_SETTLING_ERROR     0.05    // share of the full scale
+
+// variables
+typedef struct {
+    uint8_t pin;
+    const char *name;
+} adc_scan_channel_t;
+
+static const adc_scan_channel_t adc_scan_channels[] = {
+#ifdef TEST_PIN_ANALOG_IO_VREF
+    {TEST_PIN_ANALOG_IO_VREF, "VREF"},
+#endif
+#ifdef TEST_PIN_ANALOG_IO_DIVIDER
+    {TEST_PIN_ANALOG_IO_DIVIDER, "Divider"},
+#endif
+#ifdef TEST_PIN_ANALOG_IO_GND
+    {TEST_PIN_ANALOG_IO_GND, "GND"},
+#endif
+#if defined(TEST_PIN_ANALOG_IO_DAC) && defined(TEST_PIN_ANALOG_IO_DAC_INPUT)
+    {TEST_PIN_ANALOG_IO_DAC_INPUT, "DAC input"},
+#endif
+    {0, NULL}, // keeps the array valid without configured pins
+};
+
+#define ADC_SCAN_CHANNELS ((uint8_t)(sizeof(adc_scan_channels) / sizeof(adc_scan_channels[0]) - 1))
+
+static double settled_value[ADC_SCAN_CHANNELS + 1];
+static double single_channel_us = 0.0;
+
+/**
+ * @brief Suite setup function, runs before test suite execution begins.
+ */
+static void analogio_adc_scan_suite_setup() {
+    analogReference(DEFAULT);
+    analogReadResolution(TEST_ADC_RESOLUTION);
+#if defined(TEST_PIN_ANALOG_IO_DAC) && defined(TEST_PIN_ANALOG_IO_DAC_INPUT)
+    pinMode(TEST_PIN_ANALOG_IO_DAC, OUTPUT);
+    analogWriteResolution(8);
+    analogWrite(TEST_PIN_ANALOG_IO_DAC, 127);
+    delay(500);
+#endif
+}
+
+/**
+ * @brief Suite teardown function, runs after test suite execution is complete.
+ */
+static void analogio_adc_scan_suite_teardown() {
+}
+
+// Define test group name
+TEST_GROUP(analogio_adc_scan);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(analogio_adc_scan) {
+    if (ADC_SCAN_CHANNELS < 2) {
+        TEST_IGNORE_MESSAGE("At least two analog input pins are needed");
+    }
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(analogio_adc_scan) {
+}
+
+/**
+ * @brief Read every channel repeatedly to get its settled value and the single channel cost.
+ */
+TEST_IFX(analogio_adc_scan, test_adc_scan_settled_values)
+{
+    RunningStats sample_us;
+
+#ifdef TRACE_OUTPUT
+    Serial.println("\nchannel\t\tsettled value\tstd deviation");
+#endif
+    for (uint8_t c = 0; c < ADC_SCAN_CHANNELS; c++) {
+        RunningStats values;
+        uint8_t pin = adc_scan_channels[c].pin;
+
+        analogRead(pin); // switch to the channel
+        for (uint16_t n = 0; n < ADC_SCAN_SETTLED_SAMPLES; n++) {
+            values.add(analogRead(pin));
+        }
+        settled_value[c] = values.mean();
+
+        // Timed without processing, as the scan below
+        uint32_t start = micros();
+        for (uint16_t n = 0; n < ADC_SCAN_SETTLED_SAMPLES; n++) {
+            analogRead(pin);
+        }
+        sample_us.add((double)(micros() - start) / ADC_SCAN_SETTLED_SAMPLES);
+
+#ifdef TRACE_OUTPUT
+        Serial.print(adc_scan_channels[c].name);
+        Serial.print("\t\t");
+        Serial.print(values.mean(), 1);
+        Serial.print("\t\t");
+        Serial.println(values.stddev(), 2);
+#endif
+    }
+    single_channel_us = sample_us.mean();
+
+#ifdef TRACE_OUTPUT
+    Serial.print("Single channel: ");
+    Serial.print(single_channel_us, 2);
+    Serial.println(" us/sample");
+#endif
+    TEST_ASSERT_TRUE(single_channel_us > 0.0);
+}
+
+/**
+ * @brief Scan all channels round-robin at full speed.
+ */
+TEST_IFX(analogio_adc_scan, test_adc_scan_throughput)
+{
+    RunningStats channel_us[ADC_SCAN_CHANNELS + 1];
+    RunningStats micros_pair_us;
+
+    // Scan time, without timestamps between the samples
+    uint32_t start = micros();
+    for (uint16_t round = 0; round < ADC_SCAN_ROUNDS; round++) {
+        for (uint8_t c = 0; c < ADC_SCAN_CHANNELS; c++) {
+            analogRead(adc_scan_channels[c].pin);
+        }
+    }
+    double scan_us = (double)(micros() - start) / ADC_SCAN_ROUNDS;
+
+    // Time per sample of every channel, less the cost of the timestamps
+    for (uint16_t round = 0; round < ADC_SCAN_ROUNDS; round++) {
+        uint32_t pair_start = micros();
+        micros_pair_us.add((double)(micros() - pair_start));
+    }
+    for (uint16_t round = 0; round < ADC_SCAN_ROUNDS; round++) {
+        for (uint8_t c = 0; c < ADC_SCAN_CHANNELS; c++) {
+            uint32_t sample_start = micros();
+            analogRead(adc_scan_channels[c].pin);
+            channel_us[c].add((double)(micros() - sample_start) - micros_pair_us.mean());
+        }
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nScan of ");
+    Serial.print(ADC_SCAN_CHANNELS);
+    Serial.println(" channels");
+    for (uint8_t c = 0; c < ADC_SCAN_CHANNELS; c++) {
+        channel_us[c].print(adc_scan_channels[c].name, "us/sample");
+    }
+    Serial.print("Scan time: ");
+    Serial.print(scan_us, 2);
+    Serial.println(" us");
+    Serial.print("Effective rate per channel: ");
+    Serial.print(MICROSECONDS_PER_SECOND / scan_us, 0);
+    Serial.println(" samples/s");
+    if (single_channel_us > 0.0) {
+        Serial.print("Channel switch penalty: ");
+        Serial.print(scan_us / ADC_SCAN_CHANNELS - single_channel_us, 2);
+        Serial.println(" us/sample");
+    }
+#endif
+    TEST_ASSERT_TRUE(scan_us > 0.0);
+}
+
+/**
+ * @brief Read every channel right after every other one and report the settling error matrix.
+ */
+TEST_IFX(analogio_adc_scan, test_adc_scan_crosstalk)
+{
+    double max_error = ADC_SCAN_MAX_SETTLING_ERROR * ((1 << TEST_ADC_RESOLUTION) - 1);
+    double worst = 0.0;
+
+#ifdef TRACE_OUTPUT
+    Serial.println("\nSettling error in LSB (rows: channel read, columns: previous channel)");
+    Serial.print("\t\t");
+    for (uint8_t p = 0; p < ADC_SCAN_CHANNELS; p++) {
+        Serial.print(adc_scan_channels[p].name);
+        Serial.print("\t\t");
+    }
+    Serial.println();
+#endif
+    for (uint8_t c = 0; c < ADC_SCAN_CHANNELS; c++) {
+#ifdef TRACE_OUTPUT
+        Serial.print(adc_scan_channels[c].name);
+        Serial.print("\t\t");
+#endif
+        for (uint8_t p = 0; p < ADC_SCAN_CHANNELS; p++) {
+            RunningStats values;
+            for (uint16_t n = 0; n < ADC_SCAN_CROSSTALK_SAMPLES; n++) {
+                analogRead(adc_scan_channels[p].pin);
+                values.add(analogRead(adc_scan_channels[c].pin));
+            }
+            double error = values.mean() - settled_value[c];
+            if (fabs(error) > fabs(worst)) {
+                worst = error;
+            }
+#ifdef TRACE_OUTPUT
+            Serial.print(error, 2);
+            Serial.print("\t\t");
+#endif
+        }
+#ifdef TRACE_OUTPUT
+        Serial.println();
+#endif
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(fabs(worst) <= max_error, "Channel switch settling error too high");
+}
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(analogio_adc_scan)
+{
+    analogio_adc_scan_suite_setup();
+
+    RUN_TEST_CASE(analogio_adc_scan, test_adc_scan_settled_values);
+    RUN_TEST_CASE(analogio_adc_scan, test_adc_scan_throughput);
+    RUN_TEST_CASE(analogio_adc_scan, test_adc_scan_crosstalk);
+
+    analogio_adc_scan_suite_teardown();
+}
@@ -26,6 +26,13 @@
  *              - Half-scale tests (VDD/2): Verifies output when the DAC is set to half of its digital range,
  *                tested under different resolutions.
  *              - One-third scale test (VDD/3): Verifies output when the DAC is driven to one-third of its full-scale value.
+ *              - Transfer function sweep: for 8, 10 and 12 bit, every Nth code (DAC_SWEEP_INTERVALS
+ *                intervals over the full range) is written and read back as the mean of
+ *                DAC_SWEEP_SAMPLES ADC samples at 12 bit. A least squares line through the
+ *                points gives the gain and offset errors against the ideal transfer function
+ *                above, the deviation of every point from the line the INL and the deviation of
+ *                every interval from its ideal step the DNL, both in DAC LSB. The points and a
+ *                summary are printed as CSV tables.
  */
 
 // test includes
@@ -45,6 +52,14 @@
 #define MAX_ADC ((int)((ANALOG_MAXIMUM/3.3)*READ_RESOLUTION))
 #define MIN_ADC ((int)((ANALOG_MINIMUM/3.3)*READ_RESOLUTION))
 
+// transfer function sweep
+#define DAC_SWEEP_INTERVALS     64
+#define DAC_SWEEP_SAMPLES       32
+#define DAC_SWEEP_SETTLE_MS     2
+#define DAC_SWEEP_ADC_BITS      12
+#define DAC_SWEEP_MAX_INL       0.01    // share of the full scale
+#define SWEEP_ADC_FULL_SCALE    ((1 << DAC_SWEEP_ADC_BITS) - 1)
+
 /**
  * @brief Validates if the actual ADC value is within the acceptable range of the expected value.
  *
@@ -112,6 +127,140 @@ static void dac_test_for_resolution_divider(uint16_t res, uint16_t divider)
     TEST_ASSERT_TRUE_MESSAGE(validate_adc_raw_value(expected_value, adc_value), msg);
 }
 
+/**
+ * @brief Ideal ADC reading (DAC_SWEEP_ADC_BITS) for a DAC code.
+ */
+static double dac_sweep_ideal(uint32_t code, uint32_t max_dac)
+{
+    double volts = ANALOG_MINIMUM + (ANALOG_MAXIMUM - ANALOG_MINIMUM) * code / max_dac;
+    return volts / 3.3 * SWEEP_ADC_FULL_SCALE;
+}
+
+/**
+ * @brief Format a value with two decimals using integers only, as newlib-nano has no
+ * float support in printf.
+ */
+static const char *dac_format_hundredths(char *buf, size_t size, double value)
+{
+    long hundredths = lround(fabs(value) * 100.0);
+    snprintf(buf, size, "%s%ld.%02ld", value < 0.0 && hundredths > 0 ? "-" : "", hundredths / 100, hundredths % 100);
+    return buf;
+}
+
+/**
+ * @brief Sweep the DAC over its full range for a given resolution and report its linearity.
+ *
+ * Prints one CSV row per point (resolution, code, ADC mean, ADC standard deviation, ideal
+ * ADC value, INL, DNL) followed by a CSV summary (resolution, gain error, offset error,
+ * maximum INL, maximum DNL).
+ */
+static void dac_sweep_for_resolution(uint16_t res)
+{
+    uint32_t max_dac = (1UL << res) - 1;
+    uint32_t step = (max_dac + 1) / DAC_SWEEP_INTERVALS;
+    uint32_t codes[DAC_SWEEP_INTERVALS + 1];
+    double means[DAC_SWEEP_INTERVALS + 1];
+    double stddevs[DAC_SWEEP_INTERVALS + 1];
+    uint16_t points = 0;
+
+    if (step == 0) {
+        step = 1;
+    }
+
+    analogWriteResolution(res);
+    analogReadResolution(DAC_SWEEP_ADC_BITS);
+    for (uint32_t code = 0; points <= DAC_SWEEP_INTERVALS; code += step) {
+        if (code > max_dac || points == DAC_SWEEP_INTERVALS) {
+            code = max_dac; // the last point is the full scale code
+        }
+        analogWrite(TEST_PIN_ANALOG_IO_DAC, code);
+        delay(DAC_SWEEP_SETTLE_MS);
+
+        RunningStats samples;
+        for (uint16_t n = 0; n < DAC_SWEEP_SAMPLES; n++) {
+            samples.add(analogRead(TEST_PIN_ANALOG_IO_DAC_INPUT));
+        }
+        codes[points] = code;
+        means[points] = samples.mean();
+        stddevs[points] = samples.stddev();
+        points++;
+        if (code == max_dac) {
+            break;
+        }
+    }
+    analogReadResolution(TEST_ADC_RESOLUTION);
+
+    // Least squares line through the points
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+    for (uint16_t i = 0; i < points; i++) {
+        sum_x += codes[i];
+        sum_y += means[i];
+        sum_xx += (double)codes[i] * codes[i];
+        sum_xy += codes[i] * means[i];
+    }
+    double gain = (points * sum_xy - sum_x * sum_y) / (points * sum_xx - sum_x * sum_x);
+    double offset = (sum_y - gain * sum_x) / points;
+    double ideal_gain = (dac_sweep_ideal(max_dac, max_dac) - dac_sweep_ideal(0, max_dac)) / max_dac;
+    double gain_error = gain / ideal_gain - 1.0;
+    double offset_error = (offset - dac_sweep_ideal(0, max_dac)) / ideal_gain;
+
+    double max_inl = 0.0;
+    double max_dnl = 0.0;
+    bool monotonic = true;
+
+    Serial.println("\ndac_resolution,code,adc_mean,adc_stddev,adc_ideal,inl_lsb,dnl_lsb");
+    for (uint16_t i = 0; i < points; i++) {
+        double inl = (means[i] - (offset + gain * codes[i])) / gain;
+        double dnl = 0.0;
+        if (i > 0) {
+            dnl = (means[i] - means[i - 1]) / gain - (double)(codes[i] - codes[i - 1]);
+            if (means[i] <= means[i - 1]) {
+                monotonic = false;
+            }
+        }
+        if (fabs(inl) > fabs(max_inl)) {
+            max_inl = inl;
+        }
+        if (fabs(dnl) > fabs(max_dnl)) {
+            max_dnl = dnl;
+        }
+
+        Serial.print(res);
+        Serial.print(",");
+        Serial.print(codes[i]);
+        Serial.print(",");
+        Serial.print(means[i], 2);
+        Serial.print(",");
+        Serial.print(stddevs[i], 2);
+        Serial.print(",");
+        Serial.print(dac_sweep_ideal(codes[i], max_dac), 2);
+        Serial.print(",");
+        Serial.print(inl, 3);
+        Serial.print(",");
+        Serial.println(dnl, 3);
+    }
+
+    Serial.println("\ndac_resolution,gain_error_percent,offset_error_lsb,max_inl_lsb,max_dnl_lsb");
+    Serial.print(res);
+    Serial.print(",");
+    Serial.print(gain_error * 100.0, 3);
+    Serial.print(",");
+    Serial.print(offset_error, 3);
+    Serial.print(",");
+    Serial.print(max_inl, 3);
+    Serial.print(",");
+    Serial.println(max_dnl, 3);
+
+    char msg[128];
+    char value[24];
+    sprintf(msg, "%u-bit sweep is not monotonic", res);
+    TEST_ASSERT_TRUE_MESSAGE(monotonic, msg);
+    sprintf(msg, "%u-bit gain error %s %% out of range", res, dac_format_hundredths(value, sizeof(value), gain_error * 100.0));
+    TEST_ASSERT_TRUE_MESSAGE(gain_error > -TOLERANCE_BELOW && gain_error < TOLERANCE_ABOVE, msg);
+    sprintf(msg, "%u-bit INL %s LSB out of range", res, dac_format_hundredths(value, sizeof(value), max_inl));
+    TEST_ASSERT_TRUE_MESSAGE(fabs(max_inl) <= DAC_SWEEP_MAX_INL * max_dac, msg);
+}
+
 /**
  * @brief Test for DAC using 8-bit resolution.
  */
@@ -143,6 +292,16 @@ TEST_IFX(analogio_dac, test_dac_write_and_read_value_12_bit)
     dac_test_for_resolution_divider(12, 3);
 }
 
+/**
+ * @brief Transfer function sweep for 8, 10 and 12 bit resolution.
+ */
+TEST_IFX(analogio_dac, test_dac_transfer_function_sweep)
+{
+    dac_sweep_for_resolution(8);
+    dac_sweep_for_resolution(10);
+    dac_sweep_for_resolution(12);
+}
+
 /**
  * @brief Bundle all tests for this test group.
  */
@@ -154,6 +313,7 @@ TEST_GROUP_RUNNER(analogio_dac)
     RUN_TEST_CASE(analogio_dac, test_dac_write_and_read_value_8_bit);
     RUN_TEST_CASE(analogio_dac, test_dac_write_and_read_value_10_bit);
     RUN_TEST_CASE(analogio_dac, test_dac_write_and_read_value_12_bit);
+    RUN_TEST_CASE(analogio_dac, test_dac_transfer_function_sweep);
 #endif
 
     analogio_dac_suite_teardown();
@@ -0,0 +1,276 @@
+/**
+ * @file test_analogio_dac_benchmark.cpp
+ * @brief DAC Performance Benchmark
+ *
+ * @details This test suite measures how fast the DAC on the board can be driven. As in
+ *          test_analogio_dac.cpp, the DAC output pin (TEST_PIN_ANALOG_IO_DAC) is read back
+ *          by the ADC at TEST_PIN_ANALOG_IO_DAC_INPUT.
+ *
+ *          The test suite includes the following cases:
+ *              - Update rate: DAC_BENCH_UPDATES back-to-back analogWrite() calls per resolution,
+ *                reported in updates/s.
+ *              - Settling time: after a step between DAC_SETTLE_LOW and DAC_SETTLE_HIGH of the
+ *                full scale, the ADC samples the output back-to-back with timestamps. The
+ *                settling time is the time of the first sample after which all samples stay
+ *                within DAC_SETTLE_BAND of the final value. Its resolution is the ADC
+ *                sample time.
+ *              - Waveform quality: a sine and a ramp table of DAC_WAVE_POINTS points are
+ *                generated point by point, each point read back after the measured
+ *                settling time. The read back values are fitted to the table by least
+ *                squares (gain and offset), the residual gives the waveform error and
+ *                the signal to error ratio.
+ */
+
+// test includes
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// defines
+#define TRACE_OUTPUT
+#define DAC_BENCH_UPDATES           1000
+#define DAC_SETTLE_STEPS            16
+#define DAC_SETTLE_SAMPLES          64
+#define DAC_SETTLE_WAIT_MS          10      // wait for the final value of a step
+#define DAC_SETTLE_LOW              0.1     // share of the full scale
+#define DAC_SETTLE_HIGH             0.9
+#define DAC_SETTLE_BAND             0.02    // share of the ADC full scale
+#define DAC_WAVE_POINTS             64
+#define DAC_WAVE_PERIODS            4
+#define DAC_WAVE_MAX_ERROR          0.05    // residual RMS as share of the amplitude
+
+// variables
+static const uint8_t dac_bench_resolutions[] = {8, 10, 12};
+static uint16_t settle_values[DAC_SETTLE_SAMPLES];
+static uint32_t settle_timestamps_us[DAC_SETTLE_SAMPLES];
+static uint16_t wave_table[DAC_WAVE_POINTS];
+static double wave_settle_us = 0.0;
+
+#define DAC_BENCH_RESOLUTIONS (sizeof(dac_bench_resolutions) / sizeof(dac_bench_resolutions[0]))
+#define ADC_FULL_SCALE        ((1 << TEST_ADC_RESOLUTION) - 1)
+
+/**
+ * @brief Write a step to the DAC and return the settling time in microseconds.
+ */
+static double dac_step_settling_us(uint16_t from, uint16_t to) {
+    analogWrite(TEST_PIN_ANALOG_IO_DAC, from);
+    delay(DAC_SETTLE_WAIT_MS);
+
+    uint32_t start = micros();
+    analogWrite(TEST_PIN_ANALOG_IO_DAC, to);
+    for (uint16_t n = 0; n < DAC_SETTLE_SAMPLES; n++) {
+        settle_values[n] = analogRead(TEST_PIN_ANALOG_IO_DAC_INPUT);
+        settle_timestamps_us[n] = micros() - start;
+    }
+
+    delay(DAC_SETTLE_WAIT_MS);
+    int final_value = analogRead(TEST_PIN_ANALOG_IO_DAC_INPUT);
+    int band = (int)(DAC_SETTLE_BAND * ADC_FULL_SCALE);
+
+    /* Search backwards for the last sample outside the band */
+    int16_t last_outside = -1;
+    for (int16_t n = DAC_SETTLE_SAMPLES - 1; n >= 0; n--) {
+        if (abs((int)settle_values[n] - final_value) > band) {
+            last_outside = n;
+            break;
+        }
+    }
+    if (last_outside == DAC_SETTLE_SAMPLES - 1) {
+        return -1.0; // not settled within the sampled window
+    }
+    return (double)settle_timestamps_us[last_outside + 1];
+}
+
+/**
+ * @brief Generate the table DAC_WAVE_PERIODS times, read every point back and report the fit.
+ *
+ * @return The residual RMS as a share of the table amplitude.
+ */
+static double dac_wave_quality(const char *name, uint16_t max_dac) {
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0, sum_yy = 0.0;
+    uint32_t n = 0;
+
+    uint32_t start = micros();
+    for (uint8_t period = 0; period < DAC_WAVE_PERIODS; period++) {
+        for (uint16_t i = 0; i < DAC_WAVE_POINTS; i++) {
+            analogWrite(TEST_PIN_ANALOG_IO_DAC, wave_table[i]);
+            delayMicroseconds((unsigned int)wave_settle_us);
+            double x = wave_table[i];
+            double y = analogRead(TEST_PIN_ANALOG_IO_DAC_INPUT);
+            sum_x += x;
+            sum_y += y;
+            sum_xx += x * x;
+            sum_xy += x * y;
+            sum_yy += y * y;
+            n++;
+        }
+    }
+    uint32_t elapsed = micros() - start;
+
+    /* Least squares fit y = gain * x + offset, the residual
+    sum of squares follows from the sums without a buffer */
+    double sxx = sum_xx - sum_x * sum_x / n;
+    double sxy = sum_xy - sum_x * sum_y / n;
+    double syy = sum_yy - sum_y * sum_y / n;
+    double gain = sxx > 0.0 ? sxy / sxx : 0.0;
+    double offset = (sum_y - gain * sum_x) / n;
+    double residual = syy - gain * sxy;
+    double residual_rms = residual > 0.0 ? sqrt(residual / n) : 0.0;
+    double signal_rms = sqrt(syy / n);
+    double amplitude = gain * max_dac;
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\n");
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print((double)n * MICROSECONDS_PER_SECOND / (elapsed > 0 ? elapsed : 1), 0);
+    Serial.print(" points/s, gain ");
+    Serial.print(gain, 4);
+    Serial.print(" LSB/code, offset ");
+    Serial.print(offset, 1);
+    Serial.print(" LSB, residual RMS ");
+    Serial.print(residual_rms, 2);
+    Serial.print(" LSB, signal to error ");
+    Serial.print(residual_rms > 0.0 ? 20.0 * log10(signal_rms / residual_rms) : 0.0, 1);
+    Serial.println(" dB");
+#endif
+
+    TEST_ASSERT_TRUE_MESSAGE(gain > 0.0, "ADC read back does not follow the DAC output");
+    return amplitude > 0.0 ? residual_rms / amplitude : 1.0;
+}
+
+/**
+ * @brief Suite setup function, runs before test suite execution begins.
+ */
+static void analogio_dac_benchmark_suite_setup() {
+    pinMode(TEST_PIN_ANALOG_IO_DAC, OUTPUT);
+    analogReadResolution(TEST_ADC_RESOLUTION);
+}
+
+/**
+ * @brief Suite teardown function, runs after test suite execution is complete.
+ */
+static void analogio_dac_benchmark_suite_teardown() {
+}
+
+// Define test group name
+TEST_GROUP(analogio_dac_benchmark);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(analogio_dac_benchmark) { }
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(analogio_dac_benchmark) { }
+
+/**
+ * @brief Measure the maximum rate of back-to-back analogWrite() calls per resolution.
+ */
+TEST_IFX(analogio_dac_benchmark, test_dac_max_update_rate)
+{
+#ifdef TRACE_OUTPUT
+    Serial.println("\nresolution\tupdates/s\tus/update");
+#endif
+    for (uint8_t i = 0; i < DAC_BENCH_RESOLUTIONS; i++) {
+        uint8_t resolution = dac_bench_resolutions[i];
+        uint16_t max_dac = (1 << resolution) - 1;
+
+        analogWriteResolution(resolution);
+        analogWrite(TEST_PIN_ANALOG_IO_DAC, 0); // the first write may include the pin setup
+
+        uint32_t start = micros();
+        for (uint16_t n = 0; n < DAC_BENCH_UPDATES; n++) {
+            analogWrite(TEST_PIN_ANALOG_IO_DAC, (n & 1) ? max_dac : 0);
+        }
+        uint32_t elapsed = micros() - start;
+
+#ifdef TRACE_OUTPUT
+        Serial.print(resolution);
+        Serial.print("\t\t");
+        Serial.print((double)DAC_BENCH_UPDATES * MICROSECONDS_PER_SECOND / (elapsed > 0 ? elapsed : 1), 0);
+        Serial.print("\t\t");
+        Serial.println((double)elapsed / DAC_BENCH_UPDATES, 2);
+#endif
+        TEST_ASSERT_TRUE(elapsed > 0);
+    }
+}
+
+/**
+ * @brief Measure the settling time of rising and falling steps through the ADC loopback.
+ */
+TEST_IFX(analogio_dac_benchmark, test_dac_settling_time)
+{
+    analogWriteResolution(10);
+    uint16_t max_dac = (1 << 10) - 1;
+    uint16_t low = (uint16_t)(DAC_SETTLE_LOW * max_dac);
+    uint16_t high = (uint16_t)(DAC_SETTLE_HIGH * max_dac);
+    RunningStats rising;
+    RunningStats falling;
+    uint8_t unsettled = 0;
+
+    for (uint8_t step = 0; step < DAC_SETTLE_STEPS; step++) {
+        double us = dac_step_settling_us(low, high);
+        if (us < 0.0) {
+            unsettled++;
+        } else {
+            rising.add(us);
+        }
+        us = dac_step_settling_us(high, low);
+        if (us < 0.0) {
+            unsettled++;
+        } else {
+            falling.add(us);
+        }
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nADC sample time: ");
+    Serial.print((double)settle_timestamps_us[DAC_SETTLE_SAMPLES - 1] / DAC_SETTLE_SAMPLES, 2);
+    Serial.println(" us");
+    rising.print("Rising step settling time", "us");
+    falling.print("Falling step settling time", "us");
+#endif
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(0, unsettled, "DAC output not settled within the sampled window");
+
+    wave_settle_us = rising.maximum() > falling.maximum() ? rising.maximum() : falling.maximum();
+}
+
+/**
+ * @brief Generate a sine and a ramp table and report the read back waveform error.
+ */
+TEST_IFX(analogio_dac_benchmark, test_dac_waveform_quality)
+{
+    analogWriteResolution(10);
+    uint16_t max_dac = (1 << 10) - 1;
+
+    for (uint16_t i = 0; i < DAC_WAVE_POINTS; i++) {
+        wave_table[i] = (uint16_t)(max_dac * (0.5 + 0.5 * sin(2.0 * M_PI * i / DAC_WAVE_POINTS)) + 0.5);
+    }
+    double sine_error = dac_wave_quality("Sine", max_dac);
+
+    for (uint16_t i = 0; i < DAC_WAVE_POINTS; i++) {
+        wave_table[i] = (uint16_t)((uint32_t)max_dac * i / (DAC_WAVE_POINTS - 1));
+    }
+    double ramp_error = dac_wave_quality("Ramp", max_dac);
+
+    TEST_ASSERT_TRUE_MESSAGE(sine_error <= DAC_WAVE_MAX_ERROR, "Sine waveform error too high");
+    TEST_ASSERT_TRUE_MESSAGE(ramp_error <= DAC_WAVE_MAX_ERROR, "Ramp waveform error too high");
+}
+
+/**
+ * @brief Bundle all tests for this test group.
+ */
+TEST_GROUP_RUNNER(analogio_dac_benchmark)
+{
+#ifdef TEST_PIN_ANALOG_IO_DAC
+    analogio_dac_benchmark_suite_setup();
+
+    RUN_TEST_CASE(analogio_dac_benchmark, test_dac_max_update_rate);
+    RUN_TEST_CASE(analogio_dac_benchmark, test_dac_settling_time);
+    RUN_TEST_CASE(analogio_dac_benchmark, test_dac_waveform_quality);
+
+    analogio_dac_benchmark_suite_teardown();
+#endif
+}
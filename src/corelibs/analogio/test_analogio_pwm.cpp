@@ -5,6 +5,18 @@
  * only one board is needed with PWM_PIN_OUTPUT (TEST_PIN_DIGITAL_IO_OUTPUT) pin connected to 
  * PWM_PIN_FEEDBACK (TEST_PIN_DIGITAL_IO_INPUT) pin for the test cases to work as expected.
  * 
+ * The feedback interrupt only stores the timestamp and level of every edge in a buffer
+ * of PWM_CAPTURE_EDGES entries. Frequency and duty cycle are averaged over all complete
+ * periods of the buffer, so the micros() resolution and the interrupt latency spread
+ * over PWM_CAPTURE_EDGES / 2 periods, and the period jitter is the standard deviation
+ * of the single periods. Edges lost because the interrupt could not keep up show as
+ * two consecutive edges of the same level; periods around them are not used.
+ *
+ * Instead of a fixed delay, every new configuration is settled adaptively: the capture
+ * runs while the periods arrive and settling is done once PWM_SETTLE_STABLE_PERIODS
+ * consecutive periods agree in period and high time with their predecessor within
+ * PWM_SETTLE_TOLERANCE, or once no edge arrived for PWM_SETTLE_STABLE_PERIODS periods
+ * (0% and 100% duty cycle). PWM_SETTLE_MAX_MS caps the wait if the output does not converge.
  */
 
 // std includes
@@ -21,65 +33,220 @@
 #define TOLERANCE_FREQUENCY 10.0f           // 10 Hz tolerance for frequency
 #define PWM_PIN_OUTPUT      TEST_PIN_DIGITAL_IO_OUTPUT
 #define PWM_PIN_FEEDBACK    TEST_PIN_DIGITAL_IO_INPUT
-
-volatile uint32_t start_time = 0;            // Timestamp of the last rising edge
-volatile uint32_t high_time = 0;             // Duration of the HIGH period
-volatile uint32_t low_time = 0;              // Duration of the LOW period
-volatile bool high_measured = false;         // Flag to indicate a full PWM cycle has been measured
+#define PWM_CAPTURE_EDGES           129     // 64 periods and the closing rising edge
+#define PWM_CAPTURE_TIMEOUT_MS      2000
+#define PWM_RANGE_MAX_ERROR         0.01f   // relative frequency error of a valid measurement
+#define PWM_MATRIX_DUTY_TOLERANCE   2.0f    // duty cycle error of an honoured resolution, in %
+#define PWM_SETTLE_STABLE_PERIODS   4
+#define PWM_SETTLE_TOLERANCE        0.01f   // relative period and high time change of a settled period
+#define PWM_SETTLE_RESOLUTION_US    4       // micros() resolution and interrupt latency
+#define PWM_SETTLE_MAX_MS           1000
+
+volatile uint32_t edge_timestamps[PWM_CAPTURE_EDGES];  // micros() of every captured edge
+volatile uint8_t edge_levels[PWM_CAPTURE_EDGES];       // Pin level after every captured edge
+volatile uint16_t edge_count = 0;                      // Captured edges
+volatile bool capture_enabled = false;                 // Capture armed until the buffer is full
 
 // variables
 volatile float measured_duty_cycle_percentage = 0; 
-volatile uint32_t measured_frequency_hz = 0; 
+volatile float measured_frequency_hz = 0; 
+float measured_period_jitter_us = 0;
+uint16_t measured_periods = 0;
+uint16_t missed_edges = 0;
+uint16_t settle_periods = 0;
+uint32_t settle_us = 0;
+static uint32_t settle_total_us = 0;
+static uint16_t settle_configurations = 0;
+static uint16_t settle_timeouts = 0;
+
+// Frequencies for the measurement range test, 50% duty cycle
+static const uint32_t pwm_range_frequencies[] = {1000, 2000, 5000, 10000, 20000, 30000, 50000, 100000};
+static uint32_t pwm_max_measurable_hz = 0;
+
+// Frequency x resolution x duty cycle matrix, the resolutions as used by the tests above
+static const uint32_t pwm_matrix_frequencies[] = {100, 1000, 10000, 20000, 50000};
+static const uint8_t pwm_matrix_resolutions[] = {5, 8, 10, 12, 16, 20};
+static const float pwm_matrix_duty_cycles[] = {10.0f, 50.0f, 90.0f};
 
 /**
  * @brief Interrupt handler for the PWM feedback pin.
  * This function is triggered on both rising and falling edges of the PWM signal.
+ * It only stores the edge, to keep the interrupt path as short as possible.
  */
 void feedback_interrupt_handler() {
     uint32_t current_time = micros(); // Get the current timestamp
 
-    // Check the current state of the feedback pin
-    if (digitalRead(TEST_PIN_DIGITAL_IO_INPUT) == HIGH) {
-        // Rising edge detected
-        if (start_time > 0) { // Ensure this is not the first edge
-            low_time = current_time - start_time; // Measure LOW time (previous cycle)
+    if (capture_enabled) {
+        uint16_t index = edge_count;
+        edge_timestamps[index] = current_time;
+        edge_levels[index] = digitalRead(PWM_PIN_FEEDBACK);
+        if (++index == PWM_CAPTURE_EDGES) {
+            capture_enabled = false;
         }
-        start_time = current_time; // Update start_time for HIGH period
-    } else {
-        // Falling edge detected
-        high_time = current_time - start_time; // Measure HIGH time
-        start_time = current_time;             // Update start_time for LOW period
-
-        // Indicate that we have captured a full PWM cycle (HIGH + LOW)
-        high_measured = true;
+        edge_count = index;
     }
 }
 
 /**
  * @brief Function to process the measured timing and calculate duty cycle and frequency.
+ *
+ * Captures PWM_CAPTURE_EDGES edges and averages frequency and duty cycle over all
+ * complete periods (rising, falling, rising edge without a lost edge in between).
+ *
+ * @return true if at least one complete period was captured before the timeout.
  */
-void feedback_measurement_handler() {
-    uint32_t t_period;
+bool feedback_measurement_handler() {
+    RunningStats periods;
+    uint32_t sum_period = 0;
+    uint32_t sum_high = 0;
 
-    // Wait until a full PWM cycle has been measured
-    while (!high_measured);
-
-    // Disable interrupts temporarily to avoid race conditions
+    // Arm the capture and wait until the buffer is full
     noInterrupts();
+    edge_count = 0;
+    capture_enabled = true;
+    interrupts();
+
+    uint32_t start = millis();
+    while (capture_enabled && (millis() - start) < PWM_CAPTURE_TIMEOUT_MS);
+    capture_enabled = false;
+
+    uint16_t edges = edge_count;
+    missed_edges = 0;
+    for (uint16_t i = 1; i < edges; i++) {
+        if (edge_levels[i] == edge_levels[i - 1]) {
+            missed_edges++;
+        }
+    }
 
-    // Calculate the total period (HIGH + LOW)
-    t_period = high_time + low_time;
+    for (uint16_t i = 0; i + 2 < edges; i++) {
+        if (edge_levels[i] != HIGH || edge_levels[i + 1] != LOW || edge_levels[i + 2] != HIGH) {
+            continue;
+        }
+        uint32_t period = edge_timestamps[i + 2] - edge_timestamps[i];
+        sum_period += period;
+        sum_high += edge_timestamps[i + 1] - edge_timestamps[i];
+        periods.add(period);
+    }
 
-    // Calculate duty cycle and frequency
-    measured_duty_cycle_percentage = ((float)high_time / t_period) * 100.0f;
-    measured_frequency_hz = 1000000 / t_period; // Convert period to frequency
+    measured_periods = periods.count();
+    if (measured_periods == 0 || sum_period == 0) {
+        measured_frequency_hz = 0;
+        measured_duty_cycle_percentage = 0;
+        measured_period_jitter_us = 0;
+        return false;
+    }
 
-    // Reset the measurement flag
-    high_measured = false;
+    measured_frequency_hz = 1000000.0f * measured_periods / sum_period; // Convert period to frequency
+    measured_duty_cycle_percentage = ((float)sum_high / sum_period) * 100.0f;
+    measured_period_jitter_us = periods.stddev();
+    return true;
+}
 
-    // Re-enable interrupts
+/**
+ * @brief Wait until the PWM output settled after a new frequency or duty cycle.
+ *
+ * Stores the periods and the time needed in settle_periods and settle_us.
+ *
+ * @param frequency_hz Frequency of the new configuration, sets the time without edges
+ *                     after which a constant level counts as settled.
+ * @return true if the output settled within PWM_SETTLE_MAX_MS.
+ */
+static bool pwm_settle(uint32_t frequency_hz) {
+    uint32_t period_us = 1000000UL / frequency_hz;
+    uint32_t quiet_us = PWM_SETTLE_STABLE_PERIODS * period_us + PWM_SETTLE_RESOLUTION_US;
+    uint32_t last_period = 0;
+    uint32_t last_high = 0;
+    uint32_t last_edge = 0;
+    uint16_t processed = 0;
+    uint16_t stable = 0;
+    bool settled = false;
+
+    settle_periods = 0;
+    noInterrupts();
+    edge_count = 0;
+    capture_enabled = true;
     interrupts();
 
+    uint32_t start = micros();
+    last_edge = start;
+    while ((micros() - start) < PWM_SETTLE_MAX_MS * 1000UL) {
+        uint32_t now = micros();
+        uint16_t edges = edge_count;
+
+        for (; processed < edges; processed++) {
+            last_edge = edge_timestamps[processed];
+            if (processed < 2 || edge_levels[processed - 2] != HIGH || edge_levels[processed - 1] != LOW ||
+                edge_levels[processed] != HIGH) {
+                continue;
+            }
+            uint32_t period = edge_timestamps[processed] - edge_timestamps[processed - 2];
+            uint32_t high = edge_timestamps[processed - 1] - edge_timestamps[processed - 2];
+            uint32_t tolerance = (uint32_t)(PWM_SETTLE_TOLERANCE * period) + PWM_SETTLE_RESOLUTION_US;
+            settle_periods++;
+
+            if (last_period > 0 && (uint32_t)abs((int32_t)(period - last_period)) <= tolerance &&
+                (uint32_t)abs((int32_t)(high - last_high)) <= tolerance) {
+                stable++;
+            } else {
+                stable = 0;
+            }
+            last_period = period;
+            last_high = high;
+        }
+
+        // Edges may arrive after now was taken
+        if (stable >= PWM_SETTLE_STABLE_PERIODS || (int32_t)(now - last_edge) > (int32_t)quiet_us) {
+            settled = true;
+            break;
+        }
+        if (!capture_enabled && processed == PWM_CAPTURE_EDGES) {
+            // Buffer full, continue with a new one
+            noInterrupts();
+            edge_count = 0;
+            capture_enabled = true;
+            interrupts();
+            processed = 0;
+        }
+    }
+    capture_enabled = false;
+
+    settle_us = micros() - start;
+    settle_total_us += settle_us;
+    settle_configurations++;
+    if (!settled) {
+        settle_timeouts++;
+    }
+    return settled;
+}
+
+/**
+ * @brief Print the frequency error, duty cycle error and period jitter of the last measurement.
+ */
+static void feedback_report(float expected_frequency_hz, float expected_duty_cycle_percentage) {
+#ifdef TRACE_OUTPUT
+    Serial.print("\nPWM ");
+    Serial.print(expected_frequency_hz, 0);
+    Serial.print(" Hz ");
+    Serial.print(expected_duty_cycle_percentage, 1);
+    Serial.print(" %: frequency error ");
+    Serial.print(measured_frequency_hz - expected_frequency_hz, 2);
+    Serial.print(" Hz, duty cycle error ");
+    Serial.print(measured_duty_cycle_percentage - expected_duty_cycle_percentage, 2);
+    Serial.print(" %, period jitter ");
+    Serial.print(measured_period_jitter_us, 2);
+    Serial.print(" us, ");
+    Serial.print(measured_periods);
+    Serial.print(" periods, ");
+    Serial.print(missed_edges);
+    Serial.print(" missed edges, settled after ");
+    Serial.print(settle_periods);
+    Serial.print(" periods (");
+    Serial.print(settle_us);
+    Serial.println(" us)");
+#else
+    (void)expected_frequency_hz;
+    (void)expected_duty_cycle_percentage;
+#endif
 }
 
 /**
@@ -96,6 +263,15 @@ static void analogio_pwm_suite_setup() {
  */
 static void analogio_pwm_suite_teardown() {
     detachInterrupt(digitalPinToInterrupt(PWM_PIN_FEEDBACK));
+#ifdef TRACE_OUTPUT
+    Serial.print("\nSettling: ");
+    Serial.print(settle_configurations);
+    Serial.print(" configurations in ");
+    Serial.print(settle_total_us / 1000UL);
+    Serial.print(" ms, ");
+    Serial.print(settle_timeouts);
+    Serial.println(" not settled within the cap");
+#endif
 }
 
 // Define test group name
@@ -107,12 +283,10 @@ TEST_GROUP(analogio_pwm);
 static TEST_SETUP(analogio_pwm) {
     interrupts();
     setAnalogWriteFrequency(PWM_PIN_OUTPUT, PWM_FREQUENCY_HZ); //set back to default fz
-    delay(1000); 
+    pwm_settle(PWM_FREQUENCY_HZ);
     // Reset the measurement variables
-    start_time = 0;
-    high_time = 0;
-    low_time = 0;
-    high_measured = false;
+    capture_enabled = false;
+    edge_count = 0;
 }
 
 /**
@@ -131,11 +305,11 @@ TEST_IFX(analogio_pwm, test_analog_set_fz)
     //Set the frequency followed by a analogWrite
     analogWriteResolution(16); 
     setAnalogWriteFrequency(PWM_PIN_OUTPUT, 100); 
-    delay(1000); 
     // 32767 for 50% duty cycle
     analogWrite(PWM_PIN_OUTPUT, 32767); 
-    delay(1000); 
-    feedback_measurement_handler();
+    pwm_settle(100);
+    TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+    feedback_report(100, 50.0f);
     TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, 100, measured_frequency_hz);
 
     // Frequency array in test_config.h
@@ -143,8 +317,9 @@ TEST_IFX(analogio_pwm, test_analog_set_fz)
     {
         // Set different frequencies and verify the output
         setAnalogWriteFrequency(PWM_PIN_OUTPUT, test_pwm_frequencies[i]);
-        delay(1000); // Wait for the signal to stabilize
-        feedback_measurement_handler();
+        pwm_settle(test_pwm_frequencies[i]); // Wait for the signal to stabilize
+        TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+        feedback_report(test_pwm_frequencies[i], 50.0f);
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, test_pwm_frequencies[i], measured_frequency_hz);
     }
 }
@@ -163,9 +338,10 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_8_bit_resolution)
     for (size_t i = 0; i < sizeof(expected_duty_cycles) / sizeof(expected_duty_cycles[0]); i++) {
         analogWrite(PWM_PIN_OUTPUT, analog_write_values[i]);
 
-        delay(1000); // Wait for the signal to stabilize
+        pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
 
-        feedback_measurement_handler();
+        TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+        feedback_report(PWM_FREQUENCY_HZ, expected_duty_cycles[i]);
 
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_DUTY_CYCLE, expected_duty_cycles[i], measured_duty_cycle_percentage);
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, PWM_FREQUENCY_HZ, measured_frequency_hz);
@@ -186,9 +362,10 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_10_bit_resolution)
     for (size_t i = 0; i < sizeof(expected_duty_cycles) / sizeof(expected_duty_cycles[0]); i++) {
         analogWrite(PWM_PIN_OUTPUT, analog_write_values[i]);
 
-        delay(1000); // Wait for the signal to stabilize
+        pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
 
-        feedback_measurement_handler();
+        TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+        feedback_report(PWM_FREQUENCY_HZ, expected_duty_cycles[i]);
 
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_DUTY_CYCLE, expected_duty_cycles[i], measured_duty_cycle_percentage);
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, PWM_FREQUENCY_HZ, measured_frequency_hz);
@@ -209,9 +386,10 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_12_bit_resolution)
     for (size_t i = 0; i < sizeof(expected_duty_cycles) / sizeof(expected_duty_cycles[0]); i++) {
         analogWrite(PWM_PIN_OUTPUT, analog_write_values[i]);
 
-        delay(1000); // Wait for the signal to stabilize
+        pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
 
-        feedback_measurement_handler();
+        TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+        feedback_report(PWM_FREQUENCY_HZ, expected_duty_cycles[i]);
 
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_DUTY_CYCLE, expected_duty_cycles[i], measured_duty_cycle_percentage);
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, PWM_FREQUENCY_HZ, measured_frequency_hz);
@@ -232,9 +410,10 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_16_bit_resolution)
     for (size_t i = 0; i < sizeof(expected_duty_cycles) / sizeof(expected_duty_cycles[0]); i++) {
         analogWrite(PWM_PIN_OUTPUT, analog_write_values[i]);
 
-        delay(1000); // Wait for the signal to stabilize
+        pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
 
-        feedback_measurement_handler();
+        TEST_ASSERT_TRUE_MESSAGE(feedback_measurement_handler(), "No PWM period captured");
+        feedback_report(PWM_FREQUENCY_HZ, expected_duty_cycles[i]);
 
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_DUTY_CYCLE, expected_duty_cycles[i], measured_duty_cycle_percentage);
         TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_FREQUENCY, PWM_FREQUENCY_HZ, measured_frequency_hz);
@@ -248,7 +427,12 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_100_percentage_dutycycle)
 {
     analogWriteResolution(16);
     analogWrite(PWM_PIN_OUTPUT, 65535);  
-    delay(1000); // Wait for the signal to stabilize
+    pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
+#ifdef TRACE_OUTPUT
+    Serial.print("\nSettled after ");
+    Serial.print(settle_us);
+    Serial.println(" us");
+#endif
 
     TEST_ASSERT_EQUAL_MESSAGE(HIGH, digitalRead(PWM_PIN_FEEDBACK), "PWM output should be HIGH when 100 percentage duty cycle is set");
     // Check once again if the PWM pin is still HIGH
@@ -262,13 +446,176 @@ TEST_IFX(analogio_pwm, test_analog_write_pwm_0_percentage_dutycycle)
 {
     analogWriteResolution(8);
     analogWrite(PWM_PIN_OUTPUT, 0);  
-    delay(1000); // Wait for the signal to stabilize
+    pwm_settle(PWM_FREQUENCY_HZ); // Wait for the signal to stabilize
+#ifdef TRACE_OUTPUT
+    Serial.print("\nSettled after ");
+    Serial.print(settle_us);
+    Serial.println(" us");
+#endif
 
     TEST_ASSERT_EQUAL_MESSAGE(LOW, digitalRead(PWM_PIN_FEEDBACK), "PWM output should be LOW when 0 percentage duty cycle is set");
     // Check once again if the PWM pin is still LOW
     TEST_ASSERT_EQUAL_MESSAGE(LOW, digitalRead(PWM_PIN_FEEDBACK), "PWM output should be LOW when 0 percentage duty cycle is set");
 }
 
+/**
+ * @brief Find the highest PWM frequency the feedback measurement resolves at 50% duty cycle.
+ *
+ * A frequency is measured correctly if no edge was lost and the averaged frequency is
+ * within PWM_RANGE_MAX_ERROR of the requested one.
+ */
+TEST_IFX(analogio_pwm, test_analog_pwm_measurement_range)
+{
+    analogWriteResolution(16);
+    analogWrite(PWM_PIN_OUTPUT, 32767);
+
+    for (size_t i = 0; i < sizeof(pwm_range_frequencies) / sizeof(pwm_range_frequencies[0]); i++) {
+        uint32_t frequency = pwm_range_frequencies[i];
+        setAnalogWriteFrequency(PWM_PIN_OUTPUT, frequency);
+        pwm_settle(frequency); // Wait for the signal to stabilize
+
+        bool captured = feedback_measurement_handler();
+        feedback_report(frequency, 50.0f);
+
+        float error = fabs(measured_frequency_hz - frequency) / frequency;
+        if (!captured || missed_edges > 0 || error > PWM_RANGE_MAX_ERROR) {
+            break;
+        }
+        pwm_max_measurable_hz = frequency;
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nHighest measurable PWM frequency: ");
+    Serial.print(pwm_max_measurable_hz);
+    Serial.println(" Hz");
+#endif
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(PWM_FREQUENCY_HZ, pwm_max_measurable_hz,
+                                                "PWM measurement range below the default frequency");
+}
+
+/**
+ * @brief Resolution analogWrite() applies for a requested resolution.
+ *
+ * Any value lesser than or equal to 8 is considered as 8-bit resolution,
+ * any value greater than 12 as 16-bit resolution.
+ */
+static uint8_t pwm_effective_resolution(uint8_t resolution) {
+    if (resolution <= 8) {
+        return 8;
+    }
+    return resolution > 12 ? 16 : resolution;
+}
+
+/**
+ * @brief Measure every combination of frequency, resolution and duty cycle.
+ *
+ * Reports per combination the measured frequency and its error, the quantisation error of
+ * the written value, the measured duty cycle error, the period jitter and the periods needed
+ * to settle. A resolution is honoured at a frequency if the frequency error of all measurable
+ * duty cycles is within PWM_RANGE_MAX_ERROR and the duty cycle error within
+ * PWM_MATRIX_DUTY_TOLERANCE. Frequencies above the measurement range found by
+ * test_analog_pwm_measurement_range are skipped. That range holds for 50% duty cycle only,
+ * the shorter pulses of the other duty cycles can exceed the capture first. Such rows, with
+ * missed edges or no complete period, are reported as not measurable and do not count for
+ * or against the resolution.
+ */
+TEST_IFX(analogio_pwm, test_analog_pwm_frequency_resolution_matrix)
+{
+    const size_t frequencies = sizeof(pwm_matrix_frequencies) / sizeof(pwm_matrix_frequencies[0]);
+    const size_t resolutions = sizeof(pwm_matrix_resolutions) / sizeof(pwm_matrix_resolutions[0]);
+    uint32_t highest_honoured_hz[sizeof(pwm_matrix_resolutions) / sizeof(pwm_matrix_resolutions[0])] = {0};
+    uint16_t measurements = 0;
+
+#ifdef TRACE_OUTPUT
+    Serial.println("\nfrequency\tresolution\tduty %\tvalue\tmeasured Hz\tfreq err %\tquant err %\tduty err %\tjitter us\tsettle periods");
+#endif
+    for (size_t f = 0; f < frequencies; f++) {
+        uint32_t frequency = pwm_matrix_frequencies[f];
+        if (pwm_max_measurable_hz > 0 && frequency > pwm_max_measurable_hz) {
+            continue;
+        }
+
+        for (size_t r = 0; r < resolutions; r++) {
+            uint8_t resolution = pwm_matrix_resolutions[r];
+            uint32_t max_value = (1UL << pwm_effective_resolution(resolution)) - 1;
+            bool honoured = true;
+            uint8_t measurable = 0;
+
+            analogWriteResolution(resolution);
+            setAnalogWriteFrequency(PWM_PIN_OUTPUT, frequency);
+
+            for (size_t d = 0; d < sizeof(pwm_matrix_duty_cycles) / sizeof(pwm_matrix_duty_cycles[0]); d++) {
+                float duty = pwm_matrix_duty_cycles[d];
+                uint32_t value = (uint32_t)(duty / 100.0f * max_value + 0.5f);
+                float quantised_duty = 100.0f * value / max_value;
+
+                analogWrite(PWM_PIN_OUTPUT, value);
+                pwm_settle(frequency);
+
+                bool captured = feedback_measurement_handler();
+                float frequency_error = 100.0f * (measured_frequency_hz - frequency) / frequency;
+                float duty_error = measured_duty_cycle_percentage - quantised_duty;
+                measurements++;
+
+                // A limit of the measurement, not of the PWM
+                bool is_measurable = captured && missed_edges == 0;
+                if (is_measurable) {
+                    measurable++;
+                    if (fabs(frequency_error) > 100.0f * PWM_RANGE_MAX_ERROR ||
+                        fabs(duty_error) > PWM_MATRIX_DUTY_TOLERANCE) {
+                        honoured = false;
+                    }
+                }
+
+#ifdef TRACE_OUTPUT
+                Serial.print(frequency);
+                Serial.print("\t\t");
+                Serial.print(resolution);
+                Serial.print("\t\t");
+                Serial.print(duty, 0);
+                Serial.print("\t");
+                Serial.print(value);
+                Serial.print("\t");
+                if (!is_measurable) {
+                    Serial.print("not measurable, ");
+                    Serial.print(missed_edges);
+                    Serial.println(" missed edges");
+                    continue;
+                }
+                Serial.print(measured_frequency_hz, 1);
+                Serial.print("\t\t");
+                Serial.print(frequency_error, 3);
+                Serial.print("\t\t");
+                Serial.print(quantised_duty - duty, 3);
+                Serial.print("\t\t");
+                Serial.print(duty_error, 3);
+                Serial.print("\t\t");
+                Serial.print(measured_period_jitter_us, 2);
+                Serial.print("\t\t");
+                Serial.println(settle_periods);
+#endif
+            }
+
+            if (honoured && measurable > 0 && frequency > highest_honoured_hz[r]) {
+                highest_honoured_hz[r] = frequency;
+            }
+        }
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.println("\nresolution\thighest honoured frequency (Hz)");
+    for (size_t r = 0; r < resolutions; r++) {
+        Serial.print(pwm_matrix_resolutions[r]);
+        Serial.print("\t\t");
+        Serial.println(highest_honoured_hz[r]);
+    }
+#endif
+    TEST_ASSERT_GREATER_THAN_UINT16(0, measurements);
+    for (size_t r = 0; r < resolutions; r++) {
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, highest_honoured_hz[r], "Resolution not honoured at any frequency");
+    }
+}
+
 /**
  * @brief Bundle all tests to be executed for this test group.
  */
@@ -283,6 +630,8 @@ TEST_GROUP_RUNNER(analogio_pwm)
     RUN_TEST_CASE(analogio_pwm, test_analog_write_pwm_16_bit_resolution);
     RUN_TEST_CASE(analogio_pwm, test_analog_write_pwm_100_percentage_dutycycle);
     RUN_TEST_CASE(analogio_pwm, test_analog_write_pwm_0_percentage_dutycycle);
+    RUN_TEST_CASE(analogio_pwm, test_analog_pwm_measurement_range);
+    RUN_TEST_CASE(analogio_pwm, test_analog_pwm_frequency_resolution_matrix);
 
     analogio_pwm_suite_teardown();
 }
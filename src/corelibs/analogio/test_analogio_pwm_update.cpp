@@ -0,0 +1,286 @@
+/**
+ * @brief test_analogio_pwm_update.cpp
+ *
+ * @details This test verifies duty cycle changes of a running PWM output.
+ * only one board is needed with PWM_PIN_OUTPUT (TEST_PIN_DIGITAL_IO_OUTPUT) pin connected to
+ * PWM_PIN_FEEDBACK (TEST_PIN_DIGITAL_IO_INPUT) pin, as for test_analogio_pwm.cpp.
+ *
+ * The feedback interrupt stores the timestamp and level of every edge in a buffer of
+ * PWM_UPDATE_EDGES entries, armed per measurement. The test cases:
+ * - Update latency: the duty cycle is switched from PWM_UPDATE_DUTY_FROM to PWM_UPDATE_DUTY_TO
+ *   at PWM_UPDATE_TRIALS different phases of the period. The latency is the time from the
+ *   analogWrite() call to the rising edge of the first period with the new duty cycle.
+ *   Periods with neither duty cycle between the call and that period are glitches.
+ * - Duty change every period: right after every rising edge the next duty cycle of
+ *   pwm_update_sequence is written. Every captured period must have the nominal length and
+ *   the high time of one of the written duty cycles; a truncated or stretched pulse, a
+ *   double pulse or a lost period is a glitch.
+ *
+ * The edges are timestamped with micros(), the tolerances therefore include the micros()
+ * resolution and the interrupt latency.
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define PWM_PIN_OUTPUT              TEST_PIN_DIGITAL_IO_OUTPUT
+#define PWM_PIN_FEEDBACK            TEST_PIN_DIGITAL_IO_INPUT
+#define PWM_UPDATE_FREQUENCY_HZ     1000
+#define PWM_UPDATE_RESOLUTION       8
+#define PWM_UPDATE_EDGES            256
+#define PWM_UPDATE_TIMEOUT_MS       2000
+#define PWM_UPDATE_SETTLE_MS        100
+#define PWM_UPDATE_TRIALS           20
+#define PWM_UPDATE_DUTY_FROM        25.0f
+#define PWM_UPDATE_DUTY_TO          75.0f
+#define PWM_UPDATE_TOLERANCE_US     (PWM_UPDATE_PERIOD_US / 50 + 4)    // 2% of the period and the micros() resolution
+#define PWM_UPDATE_PERIOD_US        (1000000UL / PWM_UPDATE_FREQUENCY_HZ)
+#define PWM_UPDATE_MAX_LATENCY      2       // periods
+
+volatile uint32_t edge_timestamps[PWM_UPDATE_EDGES];   // micros() of every captured edge
+volatile uint8_t edge_levels[PWM_UPDATE_EDGES];        // Pin level after every captured edge
+volatile uint16_t edge_count = 0;                      // Captured edges
+volatile bool capture_enabled = false;                 // Capture armed until the buffer is full
+
+// variables
+static const float pwm_update_sequence[] = {20.0f, 40.0f, 60.0f, 80.0f};
+
+#define PWM_UPDATE_SEQUENCE_LENGTH (sizeof(pwm_update_sequence) / sizeof(pwm_update_sequence[0]))
+
+/**
+ * @brief Interrupt handler for the PWM feedback pin, stores every edge while the capture is armed.
+ */
+static void pwm_update_interrupt_handler() {
+    uint32_t current_time = micros();
+
+    if (capture_enabled) {
+        uint16_t index = edge_count;
+        edge_timestamps[index] = current_time;
+        edge_levels[index] = digitalRead(PWM_PIN_FEEDBACK);
+        if (++index == PWM_UPDATE_EDGES) {
+            capture_enabled = false;
+        }
+        edge_count = index;
+    }
+}
+
+static void pwm_update_arm_capture() {
+    noInterrupts();
+    edge_count = 0;
+    capture_enabled = true;
+    interrupts();
+}
+
+static bool pwm_update_wait_capture() {
+    uint32_t start = millis();
+    while (capture_enabled && (millis() - start) < PWM_UPDATE_TIMEOUT_MS);
+    capture_enabled = false;
+    return edge_count == PWM_UPDATE_EDGES;
+}
+
+static uint32_t pwm_update_value(float duty) {
+    return (uint32_t)(duty / 100.0f * ((1UL << PWM_UPDATE_RESOLUTION) - 1) + 0.5f);
+}
+
+static uint32_t pwm_update_high_us(float duty) {
+    return (uint32_t)(PWM_UPDATE_PERIOD_US * pwm_update_value(duty) / ((1UL << PWM_UPDATE_RESOLUTION) - 1));
+}
+
+static bool pwm_update_matches(uint32_t high_us, float duty) {
+    uint32_t expected = pwm_update_high_us(duty);
+    uint32_t deviation = high_us > expected ? high_us - expected : expected - high_us;
+    return deviation <= PWM_UPDATE_TOLERANCE_US;
+}
+
+/**
+ * @brief Suite setup function, runs before test suite execution begins.
+ */
+static void analogio_pwm_update_suite_setup() {
+    pinMode(PWM_PIN_FEEDBACK, INPUT);
+    attachInterrupt(digitalPinToInterrupt(PWM_PIN_FEEDBACK), pwm_update_interrupt_handler, CHANGE);
+}
+
+/**
+ * @brief Suite teardown function, runs after test suite execution is complete.
+ */
+static void analogio_pwm_update_suite_teardown() {
+    detachInterrupt(digitalPinToInterrupt(PWM_PIN_FEEDBACK));
+    setAnalogWriteFrequency(PWM_PIN_OUTPUT, PWM_FREQUENCY_HZ);
+}
+
+// Define test group name
+TEST_GROUP(analogio_pwm_update);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(analogio_pwm_update) {
+    interrupts();
+    capture_enabled = false;
+    edge_count = 0;
+    analogWriteResolution(PWM_UPDATE_RESOLUTION);
+    setAnalogWriteFrequency(PWM_PIN_OUTPUT, PWM_UPDATE_FREQUENCY_HZ);
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(analogio_pwm_update) {
+    capture_enabled = false;
+}
+
+/**
+ * @brief Measure the latency from analogWrite() to the first period with the new duty cycle.
+ */
+TEST_IFX(analogio_pwm_update, test_pwm_update_latency)
+{
+    RunningStats latency_us;
+    uint16_t glitches = 0;
+    uint8_t not_applied = 0;
+
+    for (uint8_t trial = 0; trial < PWM_UPDATE_TRIALS; trial++) {
+        analogWrite(PWM_PIN_OUTPUT, pwm_update_value(PWM_UPDATE_DUTY_FROM));
+        delay(PWM_UPDATE_SETTLE_MS);
+
+        // Spread the calls over the period
+        pwm_update_arm_capture();
+        uint32_t wait_start = millis();
+        while (edge_count < 4 && capture_enabled && (millis() - wait_start) < PWM_UPDATE_TIMEOUT_MS);
+        TEST_ASSERT_TRUE_MESSAGE(edge_count >= 4, "No PWM edges on the feedback pin");
+        delayMicroseconds(trial * PWM_UPDATE_PERIOD_US / PWM_UPDATE_TRIALS);
+        uint32_t call_time = micros();
+        analogWrite(PWM_PIN_OUTPUT, pwm_update_value(PWM_UPDATE_DUTY_TO));
+        TEST_ASSERT_TRUE_MESSAGE(pwm_update_wait_capture(), "PWM edges not captured");
+
+        bool applied = false;
+        for (uint16_t i = 0; i + 2 < PWM_UPDATE_EDGES && !applied; i++) {
+            if (edge_levels[i] != HIGH || edge_levels[i + 1] != LOW || edge_levels[i + 2] != HIGH) {
+                continue;
+            }
+            /* Periods starting before the call may already show the new duty
+            cycle, if the update applies immediately */
+            if ((int32_t)(edge_timestamps[i + 1] - call_time) < 0) {
+                continue;
+            }
+            uint32_t high_us = edge_timestamps[i + 1] - edge_timestamps[i];
+            if (pwm_update_matches(high_us, PWM_UPDATE_DUTY_TO)) {
+                int32_t latency = (int32_t)(edge_timestamps[i] - call_time);
+                latency_us.add(latency > 0 ? latency : 0);
+                applied = true;
+            } else if (!pwm_update_matches(high_us, PWM_UPDATE_DUTY_FROM)) {
+                glitches++;
+            }
+        }
+        if (!applied) {
+            not_applied++;
+        }
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\n");
+    latency_us.print("Duty cycle update latency", "us");
+    Serial.print("Latency in periods: ");
+    Serial.println(latency_us.mean() / PWM_UPDATE_PERIOD_US, 2);
+    Serial.print("Glitches before the update applied: ");
+    Serial.println(glitches);
+#endif
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(0, not_applied, "New duty cycle not observed");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, glitches, "Glitch at duty cycle change");
+    TEST_ASSERT_TRUE_MESSAGE(latency_us.maximum() <= PWM_UPDATE_MAX_LATENCY * PWM_UPDATE_PERIOD_US,
+                             "Duty cycle update latency too high");
+}
+
+/**
+ * @brief Change the duty cycle in every period and verify every captured period.
+ */
+TEST_IFX(analogio_pwm_update, test_pwm_duty_change_every_period)
+{
+    uint16_t periods = 0;
+    uint16_t wrong_high = 0;
+    uint16_t wrong_period = 0;
+    uint16_t lost_edges = 0;
+    uint8_t next = 0;
+
+    analogWrite(PWM_PIN_OUTPUT, pwm_update_value(pwm_update_sequence[0]));
+    delay(PWM_UPDATE_SETTLE_MS);
+
+    pwm_update_arm_capture();
+    uint16_t handled = 0;
+    uint32_t start = millis();
+    while (capture_enabled && (millis() - start) < PWM_UPDATE_TIMEOUT_MS) {
+        uint16_t count = edge_count;
+        if (count == handled) {
+            continue;
+        }
+        handled = count;
+        if (edge_levels[count - 1] == HIGH) {
+            next = (next + 1) % PWM_UPDATE_SEQUENCE_LENGTH;
+            analogWrite(PWM_PIN_OUTPUT, pwm_update_value(pwm_update_sequence[next]));
+        }
+    }
+    capture_enabled = false;
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(PWM_UPDATE_EDGES, edge_count, "PWM edges not captured");
+
+    for (uint16_t i = 1; i < PWM_UPDATE_EDGES; i++) {
+        if (edge_levels[i] == edge_levels[i - 1]) {
+            lost_edges++;
+        }
+    }
+
+    for (uint16_t i = 0; i + 2 < PWM_UPDATE_EDGES; i++) {
+        if (edge_levels[i] != HIGH || edge_levels[i + 1] != LOW || edge_levels[i + 2] != HIGH) {
+            continue;
+        }
+        periods++;
+
+        uint32_t period_us = edge_timestamps[i + 2] - edge_timestamps[i];
+        uint32_t deviation = period_us > PWM_UPDATE_PERIOD_US ? period_us - PWM_UPDATE_PERIOD_US : PWM_UPDATE_PERIOD_US - period_us;
+        if (deviation > PWM_UPDATE_TOLERANCE_US) {
+            wrong_period++; // double pulse or stretched period
+        }
+
+        uint32_t high_us = edge_timestamps[i + 1] - edge_timestamps[i];
+        bool known = false;
+        for (uint8_t d = 0; d < PWM_UPDATE_SEQUENCE_LENGTH && !known; d++) {
+            known = pwm_update_matches(high_us, pwm_update_sequence[d]);
+        }
+        if (!known) {
+            wrong_high++; // truncated or extended pulse
+        }
+    }
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nPeriods with duty cycle change: ");
+    Serial.println(periods);
+    Serial.print("Truncated or extended pulses: ");
+    Serial.println(wrong_high);
+    Serial.print("Double pulses or stretched periods: ");
+    Serial.println(wrong_period);
+    Serial.print("Lost edges: ");
+    Serial.println(lost_edges);
+#endif
+    TEST_ASSERT_GREATER_THAN_UINT16(0, periods);
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, lost_edges, "Feedback edges lost");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, wrong_high, "Truncated or extended pulse at duty cycle change");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, wrong_period, "Double pulse or stretched period at duty cycle change");
+}
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(analogio_pwm_update)
+{
+    analogio_pwm_update_suite_setup();
+
+    RUN_TEST_CASE(analogio_pwm_update, test_pwm_update_latency);
+    RUN_TEST_CASE(analogio_pwm_update, test_pwm_duty_change_every_period);
+
+    analogio_pwm_update_suite_teardown();
+}
@@ -0,0 +1,246 @@
+/* test_can_connected2_extended_node1.cpp
+ *
+ * This test is used to verify 29-bit extended identifiers and remote frames of the CAN library.
+ * It will test the can communcation between two nodes.
+ * 2 boards must be used and connected the can_tx, can_rx, vcc and ground pins. (termination resistor is optional)
+ * ONLY WORKS WITH OTHER BOARD HAS BEEN FLASHED test_can_connected2_extended_node2.cpp
+ * This board work as the requester: it sends data and remote frames, node2 answers them.
+ *
+ * The round-trip latency (from endPacket() until the answer is received) is reported
+ * per frame type: standard data, extended data, standard remote and extended remote frames.
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define CAN_ID_STD_REQUEST   0x123      // standard data frame, answered on CAN_ID_STD_RESPONSE
+#define CAN_ID_STD_RESPONSE  0x321
+#define CAN_ID_EXT_REQUEST   0x18FF1001 // extended data frame, answered on CAN_ID_EXT_RESPONSE
+#define CAN_ID_EXT_RESPONSE  0x18FF1002
+#define CAN_ID_STD_REMOTE    0x124      // remote frames are answered with a data frame of the same id
+#define CAN_ID_EXT_REMOTE    0x18FF2001
+#define CAN_ID_DONE          0x7F0      // tells node2 to finish the group
+
+#define REMOTE_DATA_PATTERN  0xA0       // node2 answers remote frames with REMOTE_DATA_PATTERN + index
+#define REPLY_TIMEOUT_MS     100
+#define LATENCY_ITERATIONS   100
+
+// variables
+
+const static uint8_t node1Increment = 10;
+const static uint8_t node2Increment = 1;
+const static uint8_t canDataLengthMax = 8;
+
+static uint8_t node1Data[canDataLengthMax];
+
+// reply captured by the receive callback
+static uint8_t receivedData[canDataLengthMax];
+static volatile long receivedId = -1;
+static volatile bool receivedExtended = false;
+static volatile bool receivedRtr = false;
+static volatile int receivedDlc = 0;
+static volatile uint32_t receivedTimestampUs = 0;
+volatile bool newDataReceivedExtNode1 = false;
+
+typedef enum {
+    FRAME_STD_DATA = 0,
+    FRAME_EXT_DATA,
+    FRAME_STD_REMOTE,
+    FRAME_EXT_REMOTE,
+    FRAME_TYPES
+} frame_type_t;
+
+static const char *frameTypeNames[FRAME_TYPES] = {"standard data", "extended data", "standard remote",
+                                                  "extended remote"};
+
+// test feature includes requiring the above defined variables
+extern CANXMC CAN;
+
+void receiveEventExtNode1(int packetSize) {
+    receivedTimestampUs = micros();
+    receivedId = CAN.packetId();
+    receivedExtended = CAN.packetExtended();
+    receivedRtr = CAN.packetRtr();
+    receivedDlc = CAN.packetDlc();
+
+    uint8_t count = 0;
+    while (CAN.available() && count < canDataLengthMax) {
+        receivedData[count++] = CAN.read();
+    }
+    newDataReceivedExtNode1 = true;
+}
+
+// Method invoked before a test suite is run.
+void can_connected_extended_node1_suite_setup() {
+    // No acceptance filter: standard and extended answers are both received
+    CAN.begin();
+    CAN.onReceive(receiveEventExtNode1);
+}
+
+// Method invoked after a test suite is run.
+void can_connected_extended_node1_suite_teardown() {
+    CAN.beginPacket(CAN_ID_DONE);
+    CAN.endPacket();
+    CAN.end();
+}
+
+// define test group name
+TEST_GROUP(can_connected2_extended_node1);
+TEST_GROUP(can_connected2_extended_node1_internal);
+
+// Setup method called by Unity before every individual test defined for this test group.
+static TEST_SETUP(can_connected2_extended_node1_internal) {
+    memset(node1Data, 0, sizeof(node1Data));
+    memset(receivedData, 0, sizeof(receivedData));
+    newDataReceivedExtNode1 = false;
+}
+
+// Tear down method called by Unity after every individual test defined for this test group.
+static TEST_TEAR_DOWN(can_connected2_extended_node1_internal) {}
+
+/**
+ * @brief Send a request of the given frame type and wait for the answer of node2.
+ *
+ * @param type Frame type of the request.
+ * @param dataLength Data length (data frames) or requested length (remote frames).
+ * @param roundTripUs Time from endPacket() until the answer has been received.
+ * @return true if the answer has been received within REPLY_TIMEOUT_MS.
+ */
+static bool sendRequest(frame_type_t type, uint8_t dataLength, uint32_t *roundTripUs) {
+    switch (type) {
+    case FRAME_STD_DATA:
+        TEST_ASSERT_TRUE(CAN.beginPacket(CAN_ID_STD_REQUEST));
+        break;
+    case FRAME_EXT_DATA:
+        TEST_ASSERT_TRUE(CAN.beginExtendedPacket(CAN_ID_EXT_REQUEST));
+        break;
+    case FRAME_STD_REMOTE:
+        TEST_ASSERT_TRUE(CAN.beginPacket(CAN_ID_STD_REMOTE, dataLength, true));
+        break;
+    default:
+        TEST_ASSERT_TRUE(CAN.beginExtendedPacket(CAN_ID_EXT_REMOTE, dataLength, true));
+        break;
+    }
+
+    if (type == FRAME_STD_DATA || type == FRAME_EXT_DATA) {
+        TEST_ASSERT_EQUAL_UINT8(dataLength, CAN.write(node1Data, dataLength));
+    }
+
+    newDataReceivedExtNode1 = false;
+    uint32_t start = micros();
+    TEST_ASSERT_EQUAL(1, CAN.endPacket());
+
+    while (!newDataReceivedExtNode1) {
+        if ((micros() - start) > (uint32_t)REPLY_TIMEOUT_MS * 1000U) {
+            return false;
+        }
+    }
+
+    *roundTripUs = receivedTimestampUs - start;
+    newDataReceivedExtNode1 = false;
+    return true;
+}
+
+/**
+ * @brief Verify the answer of node2 to a remote frame request.
+ */
+static void checkRemoteAnswer(long id, bool extended, uint8_t dataLength) {
+    TEST_ASSERT_EQUAL(id, receivedId);
+    TEST_ASSERT_EQUAL(extended, receivedExtended);
+    TEST_ASSERT_FALSE(receivedRtr);
+    TEST_ASSERT_EQUAL(dataLength, receivedDlc);
+
+    for (uint8_t i = 0; i < dataLength; ++i) {
+        TEST_ASSERT_EQUAL_UINT8(REMOTE_DATA_PATTERN + i, receivedData[i]);
+    }
+}
+
+TEST_IFX(can_connected2_extended_node1_internal, checkExtendedPingPong) {
+    const uint8_t dataLength = canDataLengthMax;
+    uint32_t roundTripUs = 0;
+
+    for (uint8_t loop = 0; loop < 5; ++loop) {
+        TEST_ASSERT_TRUE_MESSAGE(sendRequest(FRAME_EXT_DATA, dataLength, &roundTripUs), "No answer from node2");
+
+        TEST_ASSERT_EQUAL(CAN_ID_EXT_RESPONSE, receivedId);
+        TEST_ASSERT_TRUE(receivedExtended);
+        TEST_ASSERT_FALSE(receivedRtr);
+        TEST_ASSERT_EQUAL(dataLength, receivedDlc);
+        for (uint8_t i = 0; i < dataLength; ++i) {
+            TEST_ASSERT_EQUAL_UINT8(node1Data[i] + node2Increment, receivedData[i]);
+        }
+
+#ifdef TRACE_OUTPUT
+        printArray("\nSent Data", node1Data, dataLength);
+        printArray("Received Data", receivedData, dataLength);
+#endif
+        for (uint8_t i = 0; i < dataLength; ++i) {
+            node1Data[i] = receivedData[i] + node1Increment;
+        }
+    }
+}
+
+TEST_IFX(can_connected2_extended_node1_internal, checkStandardRemoteFrame) {
+    uint32_t roundTripUs = 0;
+
+    for (uint8_t dataLength = 0; dataLength <= canDataLengthMax; ++dataLength) {
+        TEST_ASSERT_TRUE_MESSAGE(sendRequest(FRAME_STD_REMOTE, dataLength, &roundTripUs), "No answer from node2");
+        checkRemoteAnswer(CAN_ID_STD_REMOTE, false, dataLength);
+    }
+}
+
+TEST_IFX(can_connected2_extended_node1_internal, checkExtendedRemoteFrame) {
+    uint32_t roundTripUs = 0;
+
+    for (uint8_t dataLength = 0; dataLength <= canDataLengthMax; ++dataLength) {
+        TEST_ASSERT_TRUE_MESSAGE(sendRequest(FRAME_EXT_REMOTE, dataLength, &roundTripUs), "No answer from node2");
+        checkRemoteAnswer(CAN_ID_EXT_REMOTE, true, dataLength);
+    }
+}
+
+/**
+ * @brief Measure the round-trip latency per frame type with full length frames.
+ *
+ * The requests of the different frame types are interleaved, so that slow drifts
+ * (e.g. of the other node's loop) affect all frame types alike.
+ */
+TEST_IFX(can_connected2_extended_node1_internal, reportRoundTripLatency) {
+    RunningStats latency[FRAME_TYPES];
+    uint32_t roundTripUs = 0;
+
+    for (uint16_t loop = 0; loop < LATENCY_ITERATIONS; ++loop) {
+        for (uint8_t type = 0; type < FRAME_TYPES; ++type) {
+            TEST_ASSERT_TRUE_MESSAGE(sendRequest((frame_type_t)type, canDataLengthMax, &roundTripUs),
+                                     "No answer from node2");
+            latency[type].add(roundTripUs);
+        }
+    }
+
+    for (uint8_t type = 0; type < FRAME_TYPES; ++type) {
+        Serial.print("\nRound trip ");
+        latency[type].print(frameTypeNames[type], "us");
+        TEST_ASSERT_EQUAL_UINT32(LATENCY_ITERATIONS, latency[type].count());
+    }
+}
+
+static TEST_GROUP_RUNNER(can_connected2_extended_node1_internal) {
+    RUN_TEST_CASE(can_connected2_extended_node1_internal, checkExtendedPingPong);
+    RUN_TEST_CASE(can_connected2_extended_node1_internal, checkStandardRemoteFrame);
+    RUN_TEST_CASE(can_connected2_extended_node1_internal, checkExtendedRemoteFrame);
+    RUN_TEST_CASE(can_connected2_extended_node1_internal, reportRoundTripLatency);
+}
+
+// Bundle all tests to be executed for this test group
+TEST_GROUP_RUNNER(can_connected2_extended_node1) {
+    can_connected_extended_node1_suite_setup();
+
+    RUN_TEST_GROUP(can_connected2_extended_node1_internal);
+
+    can_connected_extended_node1_suite_teardown();
+}
@@ -0,0 +1,184 @@
+/* test_can_connected2_extended_node2.cpp
+ *
+ * This test is used to verify 29-bit extended identifiers and remote frames of the CAN library.
+ * It will test the can communcation between two nodes.
+ * 2 boards must be used and connected the can_tx, can_rx, vcc and ground pins. (termination resistor is optional)
+ * This board work as the responder for test_can_connected2_extended_node1.cpp:
+ * - data frames are answered with the data incremented by one,
+ * - remote frames are answered with a data frame of the same id and the requested length.
+ *
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define CAN_ID_STD_REQUEST   0x123
+#define CAN_ID_STD_RESPONSE  0x321
+#define CAN_ID_EXT_REQUEST   0x18FF1001
+#define CAN_ID_EXT_RESPONSE  0x18FF1002
+#define CAN_ID_STD_REMOTE    0x124
+#define CAN_ID_EXT_REMOTE    0x18FF2001
+#define CAN_ID_DONE          0x7F0
+
+#define REMOTE_DATA_PATTERN  0xA0
+#define IDLE_TIMEOUT_MS      10000 // maximum wait for the next request of node1
+
+// variables
+
+const static uint8_t node2Increment = 1;
+const static uint8_t canDataLengthMax = 8;
+
+static uint8_t receivedData[canDataLengthMax] = {0};
+static uint8_t node2Data[canDataLengthMax] = {0};
+static volatile long receivedId = -1;
+static volatile bool receivedExtended = false;
+// Answered frames per type: standard data, extended data, standard remote, extended remote
+static uint32_t answeredFrames[4] = {0};
+static volatile bool receivedRtr = false;
+static volatile int receivedDlc = 0;
+volatile bool newDataReceivedExtNode2 = false;
+
+// test feature includes requiring the above defined variables
+
+extern CANXMC CAN;
+
+void receiveEventExtNode2(int packetSize) {
+    receivedId = CAN.packetId();
+    receivedExtended = CAN.packetExtended();
+    receivedRtr = CAN.packetRtr();
+    receivedDlc = CAN.packetDlc();
+
+    uint8_t count = 0;
+    while (CAN.available() && count < canDataLengthMax) {
+        receivedData[count++] = CAN.read();
+    }
+    newDataReceivedExtNode2 = true;
+}
+
+// Method invoked before a test suite is run.
+void can_connected_extended_node2_suite_setup() {
+    // No acceptance filter: standard and extended requests are both received
+    CAN.begin();
+    CAN.onReceive(receiveEventExtNode2);
+}
+
+// Method invoked after a test suite is run.
+void can_connected_extended_node2_suite_teardown() { CAN.end(); }
+
+// define test group name
+TEST_GROUP(can_connected2_extended_node2);
+TEST_GROUP(can_connected2_extended_node2_internal);
+
+/**
+ * @brief Start the answer frame to the received request.
+ *
+ * @return Length of the answer, or -1 if the request is unknown.
+ */
+static int beginAnswer() {
+    uint8_t length = (uint8_t)receivedDlc;
+
+    if (receivedRtr) {
+        if (!receivedExtended && receivedId == CAN_ID_STD_REMOTE) {
+            TEST_ASSERT_TRUE(CAN.beginPacket(CAN_ID_STD_REMOTE));
+        } else if (receivedExtended && receivedId == CAN_ID_EXT_REMOTE) {
+            TEST_ASSERT_TRUE(CAN.beginExtendedPacket(CAN_ID_EXT_REMOTE));
+        } else {
+            return -1;
+        }
+        for (uint8_t i = 0; i < length; ++i) {
+            node2Data[i] = REMOTE_DATA_PATTERN + i;
+        }
+        return length;
+    }
+
+    if (!receivedExtended && receivedId == CAN_ID_STD_REQUEST) {
+        TEST_ASSERT_TRUE(CAN.beginPacket(CAN_ID_STD_RESPONSE));
+    } else if (receivedExtended && receivedId == CAN_ID_EXT_REQUEST) {
+        TEST_ASSERT_TRUE(CAN.beginExtendedPacket(CAN_ID_EXT_RESPONSE));
+    } else {
+        return -1;
+    }
+    for (uint8_t i = 0; i < length; ++i) {
+        node2Data[i] = receivedData[i] + node2Increment;
+    }
+    return length;
+}
+
+/**
+ * @brief Answer the last received request.
+ *
+ * @return false once node1 signalled the end of the group, true otherwise.
+ */
+static bool processReceivedMessagesExtNode2() {
+    if (!newDataReceivedExtNode2) {
+        return true;
+    }
+    newDataReceivedExtNode2 = false;
+
+    if (!receivedExtended && !receivedRtr && receivedId == CAN_ID_DONE) {
+#ifdef TRACE_OUTPUT
+        // Printed once at the end, a trace per answer would delay node1's next request
+        Serial.print("\nAnswered data frames: ");
+        Serial.print(answeredFrames[0]);
+        Serial.print(" standard, ");
+        Serial.print(answeredFrames[1]);
+        Serial.println(" extended");
+        Serial.print("Answered remote frames: ");
+        Serial.print(answeredFrames[2]);
+        Serial.print(" standard, ");
+        Serial.print(answeredFrames[3]);
+        Serial.println(" extended");
+#endif
+        return false;
+    }
+
+    int length = beginAnswer();
+    if (length < 0) {
+        return true;
+    }
+
+    TEST_ASSERT_EQUAL(length, CAN.write(node2Data, length));
+    TEST_ASSERT_EQUAL(1, CAN.endPacket());
+
+    answeredFrames[(receivedRtr ? 2 : 0) + (receivedExtended ? 1 : 0)]++;
+    return true;
+}
+
+// Setup method called by Unity before every individual test defined for this test group.
+static TEST_SETUP(can_connected2_extended_node2_internal) {}
+
+// Tear down method called by Unity after every individual test defined for this test group.
+static TEST_TEAR_DOWN(can_connected2_extended_node2_internal) {}
+
+TEST_IFX(can_connected2_extended_node2_internal, answerRequests) {
+    uint32_t lastRequest = millis();
+    bool running = true;
+
+    // Serve node1 until it sends the done frame
+    while (running && (millis() - lastRequest) < IDLE_TIMEOUT_MS) {
+        if (newDataReceivedExtNode2) {
+            lastRequest = millis();
+        }
+        running = processReceivedMessagesExtNode2();
+    }
+    TEST_ASSERT_FALSE_MESSAGE(running, "node1 did not finish within the idle timeout");
+}
+
+static TEST_GROUP_RUNNER(can_connected2_extended_node2_internal) {
+    RUN_TEST_CASE(can_connected2_extended_node2_internal, answerRequests);
+}
+
+// Bundle all tests to be executed for this test group
+TEST_GROUP_RUNNER(can_connected2_extended_node2) {
+    can_connected_extended_node2_suite_setup();
+
+    RUN_TEST_GROUP(can_connected2_extended_node2_internal);
+
+    can_connected_extended_node2_suite_teardown();
+}
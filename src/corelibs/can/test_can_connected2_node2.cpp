@@ -18,6 +18,8 @@
 #define TRACE_OUTPUT
 #define CAN_ID_1 0x123
 #define CAN_ID_2 0x321
+#define PING_PONG_ITERATIONS 5      // ping-pongs started by node1 in checkPingPong
+#define PING_PONG_TIMEOUT_MS 10000  // maximum wait for all ping-pongs
 
 // variables
 
@@ -58,7 +60,7 @@ void can_connected_node2_suite_teardown() { CAN.end(); }
 TEST_GROUP(can_connected2_node2);
 TEST_GROUP(can_connected2_node2_internal);
 
-void processReceivedMessagesNode2() {
+bool processReceivedMessagesNode2() {
     if (newDataReceivedNode2) {
         // Process the received data
         for (uint8_t i = 0; i < canDataLength; ++i) {
@@ -79,7 +81,9 @@ void processReceivedMessagesNode2() {
         printArray("\nReceived Data", receivedData, canDataLength);
         printArray("Sent Data", node2Data, canDataLength);
 #endif
+        return true;
     }
+    return false;
 }
 
 // Setup method called by Unity before every individual test defined for this test group.
@@ -88,7 +92,18 @@ static TEST_SETUP(can_connected2_node2_internal) {}
 // Tear down method called by Unity after every individual test defined for this test group.
 static TEST_TEAR_DOWN(can_connected2_node2_internal) {}
 
-TEST_IFX(can_connected2_node2_internal, checkPingPong) { processReceivedMessagesNode2(); }
+TEST_IFX(can_connected2_node2_internal, checkPingPong) {
+    uint8_t processed = 0;
+    uint32_t start = millis();
+
+    // Answer every ping of node1, so that both nodes finish the group together
+    while (processed < PING_PONG_ITERATIONS && (millis() - start) < PING_PONG_TIMEOUT_MS) {
+        if (processReceivedMessagesNode2()) {
+            processed++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(PING_PONG_ITERATIONS, processed);
+}
 
 static TEST_GROUP_RUNNER(can_connected2_node2_internal) {
     RUN_TEST_CASE(can_connected2_node2_internal, checkPingPong);
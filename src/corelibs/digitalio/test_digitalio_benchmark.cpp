@@ -0,0 +1,233 @@
+/* test_digitalio_benchmark.cpp
+ *
+ * This test measures the cost of the Digital IO functions.
+ * only one board is needed with TEST_PIN_DIGITAL_IO_OUTPUT pin connected to
+ * TEST_PIN_DIGITAL_IO_INPUT pin for the test cases to work as expected.
+ *
+ * - Call cost: DIGITALIO_BENCH_CALLS calls of digitalWrite(), digitalRead() and pinMode(),
+ *   repeated DIGITALIO_BENCH_RUNS times. The time of an empty loop is subtracted, the run
+ *   least disturbed by interrupts (the minimum) gives the cost per call in ns. A run lasts
+ *   milliseconds even for the fast path, so the micros() resolution does not matter.
+ * - Square wave: the output is toggled in a tight loop, the frequency is the reciprocal of
+ *   the time of a HIGH and a LOW write.
+ * - Fast path: the same for the register access of the core, if it exposes one. These are
+ *   the portOutputRegister() macros of the Arduino API or digitalToggle() on XMC. The
+ *   loopback input verifies the fast path drives the pin.
+ *
+ * DIGITALIO_MAX_WRITE_NS can be set in the test_config.h of a board to catch regressions
+ * of the digitalWrite() cost.
+ */
+
+// std includes
+
+// test includes
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// project includes
+
+// defines
+#define TRACE_OUTPUT
+#define DIGITALIO_BENCH_CALLS       100000UL
+#define DIGITALIO_BENCH_RUNS        10
+#ifndef DIGITALIO_MAX_WRITE_NS
+    #define DIGITALIO_MAX_WRITE_NS  10000
+#endif
+
+#if defined(portOutputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask)
+    #define DIGITALIO_FAST_PATH "port output register"
+#elif defined(ARDUINO_ARCH_XMC)
+    #define DIGITALIO_FAST_PATH "digitalToggle()"
+#endif
+
+/**
+ * Time DIGITALIO_BENCH_CALLS executions of the statement and store the shortest run in
+ * the variable run_us, the empty loop included. The statement can use the loop index n.
+ */
+#define DIGITALIO_BENCH(run_us, statement)                              \
+    do {                                                                \
+        run_us = UINT32_MAX;                                            \
+        for (uint8_t run = 0; run < DIGITALIO_BENCH_RUNS; run++) {      \
+            uint32_t start = micros();                                  \
+            for (uint32_t n = 0; n < DIGITALIO_BENCH_CALLS; n++) {      \
+                statement;                                              \
+                __asm__ __volatile__("");                               \
+            }                                                           \
+            uint32_t elapsed = micros() - start;                        \
+            if (elapsed < run_us) {                                     \
+                run_us = elapsed;                                       \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+// variables
+volatile uint8_t read_sink = 0;
+static uint32_t empty_loop_us = 0;
+
+// Method invoked before a test suite is run.
+static void digitalio_benchmark_suite_setup() {
+    DIGITALIO_BENCH(empty_loop_us, (void)0);
+}
+
+// Method invoked after a test suite is run.
+static void digitalio_benchmark_suite_teardown() {
+
+}
+
+// Define test group name
+TEST_GROUP(digitalio_benchmark);
+TEST_GROUP(digitalio_benchmark_internal);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(digitalio_benchmark_internal) {
+    pinMode(TEST_PIN_DIGITAL_IO_OUTPUT, OUTPUT);
+    pinMode(TEST_PIN_DIGITAL_IO_INPUT, INPUT);
+    digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, LOW);
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(digitalio_benchmark_internal) {
+}
+
+/**
+ * @brief Cost of one call in ns from the shortest run of DIGITALIO_BENCH_CALLS calls.
+ */
+static double digitalio_call_ns(uint32_t run_us) {
+    uint32_t net_us = run_us > empty_loop_us ? run_us - empty_loop_us : 0;
+    return 1000.0 * net_us / DIGITALIO_BENCH_CALLS;
+}
+
+/**
+ * @brief Square wave frequency of a loop iteration writing HIGH and LOW.
+ */
+static double digitalio_square_wave_hz(uint32_t run_us) {
+    return (double)DIGITALIO_BENCH_CALLS * MICROSECONDS_PER_SECOND / (run_us > 0 ? run_us : 1);
+}
+
+static void digitalio_report(const char *name, double value, const char *unit) {
+#ifdef TRACE_OUTPUT
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(value, 1);
+    Serial.print(" ");
+    Serial.println(unit);
+#else
+    (void)name;
+    (void)value;
+    (void)unit;
+#endif
+}
+
+/**
+ * @brief This test measures the cost of digitalWrite, digitalRead and pinMode calls.
+ */
+TEST_IFX(digitalio_benchmark_internal, test_digitalio_call_cost)
+{
+    uint32_t write_us;
+    uint32_t read_us;
+    uint32_t mode_us;
+
+    DIGITALIO_BENCH(write_us, digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, (n & 1) ? HIGH : LOW));
+    DIGITALIO_BENCH(read_us, read_sink = digitalRead(TEST_PIN_DIGITAL_IO_INPUT));
+    DIGITALIO_BENCH(mode_us, pinMode(TEST_PIN_DIGITAL_IO_INPUT, INPUT));
+
+    double write_ns = digitalio_call_ns(write_us);
+#ifdef TRACE_OUTPUT
+    Serial.print("\nEmpty loop: ");
+    Serial.print(1000.0 * empty_loop_us / DIGITALIO_BENCH_CALLS, 1);
+    Serial.println(" ns per iteration");
+#endif
+    digitalio_report("digitalWrite", write_ns, "ns");
+    digitalio_report("digitalRead", digitalio_call_ns(read_us), "ns");
+    digitalio_report("pinMode", digitalio_call_ns(mode_us), "ns");
+
+    TEST_ASSERT_TRUE_MESSAGE(write_ns <= DIGITALIO_MAX_WRITE_NS, "digitalWrite cost above DIGITALIO_MAX_WRITE_NS");
+}
+
+/**
+ * @brief This test measures the maximum square wave frequency of digitalWrite in a tight loop.
+ */
+TEST_IFX(digitalio_benchmark_internal, test_digitalio_max_square_wave)
+{
+    uint32_t wave_us;
+
+    DIGITALIO_BENCH(wave_us, digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, HIGH);
+                             digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, LOW));
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\n");
+#endif
+    digitalio_report("digitalWrite square wave", digitalio_square_wave_hz(wave_us), "Hz");
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, wave_us);
+}
+
+/**
+ * @brief This test measures the register level fast path of the core, if there is one.
+ */
+TEST_IFX(digitalio_benchmark_internal, test_digitalio_fast_path)
+{
+#if defined(DIGITALIO_FAST_PATH)
+    uint32_t set_us;
+    uint32_t wave_us;
+
+    #if defined(portOutputRegister)
+    auto output = portOutputRegister(digitalPinToPort(TEST_PIN_DIGITAL_IO_OUTPUT));
+    auto mask = digitalPinToBitMask(TEST_PIN_DIGITAL_IO_OUTPUT);
+
+    *output |= mask;
+    TEST_ASSERT_EQUAL_MESSAGE(HIGH, digitalRead(TEST_PIN_DIGITAL_IO_INPUT), "Fast path should set the pin HIGH");
+    *output &= ~mask;
+    TEST_ASSERT_EQUAL_MESSAGE(LOW, digitalRead(TEST_PIN_DIGITAL_IO_INPUT), "Fast path should set the pin LOW");
+
+    DIGITALIO_BENCH(set_us, *output |= mask);
+    DIGITALIO_BENCH(wave_us, *output |= mask; *output &= ~mask);
+    #else
+    digitalToggle(TEST_PIN_DIGITAL_IO_OUTPUT);
+    TEST_ASSERT_EQUAL_MESSAGE(HIGH, digitalRead(TEST_PIN_DIGITAL_IO_INPUT), "Fast path should set the pin HIGH");
+    digitalToggle(TEST_PIN_DIGITAL_IO_OUTPUT);
+    TEST_ASSERT_EQUAL_MESSAGE(LOW, digitalRead(TEST_PIN_DIGITAL_IO_INPUT), "Fast path should set the pin LOW");
+
+    DIGITALIO_BENCH(set_us, digitalToggle(TEST_PIN_DIGITAL_IO_OUTPUT));
+    DIGITALIO_BENCH(wave_us, digitalToggle(TEST_PIN_DIGITAL_IO_OUTPUT);
+                             digitalToggle(TEST_PIN_DIGITAL_IO_OUTPUT));
+    #endif
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nFast path: ");
+    Serial.println(DIGITALIO_FAST_PATH);
+#endif
+    digitalio_report("Fast path write", digitalio_call_ns(set_us), "ns");
+    digitalio_report("Fast path square wave", digitalio_square_wave_hz(wave_us), "Hz");
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, wave_us);
+#else
+    TEST_IGNORE_MESSAGE("No register level fast path exposed by the core");
+#endif
+}
+
+/**
+ * @brief Test group runner to run all test cases in this group.
+ */
+static TEST_GROUP_RUNNER(digitalio_benchmark_internal)
+{
+    RUN_TEST_CASE(digitalio_benchmark_internal, test_digitalio_call_cost);
+    RUN_TEST_CASE(digitalio_benchmark_internal, test_digitalio_max_square_wave);
+    RUN_TEST_CASE(digitalio_benchmark_internal, test_digitalio_fast_path);
+}
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(digitalio_benchmark)
+{
+    digitalio_benchmark_suite_setup();
+
+    RUN_TEST_GROUP(digitalio_benchmark_internal);
+
+    digitalio_benchmark_suite_teardown();
+}
@@ -0,0 +1,240 @@
+/* test_interrupts_benchmark.cpp
+ *
+ * This test measures the timing of the GPIO Interrupts per RISING, FALLING and CHANGE mode.
+ * TEST_PIN_DIGITAL_IO_OUTPUT pin should be connected to TEST_PIN_DIGITAL_IO_INPUT pin
+ * for the test cases to work as expected.
+ *
+ * - Latency: the time from the digitalWrite() call to the ISR entry, and from the ISR
+ *   entry to the main loop noticing the flag set by the ISR. Both are taken with micros(),
+ *   so the single samples have its resolution, the mean over GPIO_LATENCY_SAMPLES is finer.
+ * - Maximum edge rate: bursts of GPIO_EDGE_BURST edges are generated with decreasing gaps,
+ *   the ISR counts the edges of its mode. The highest edge rate at which the ISR count
+ *   matches the generated edges is reported. The edges of the gap 0 burst come as fast
+ *   as digitalWrite() can toggle the pin.
+ */
+
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// Defines
+#define TRACE_OUTPUT
+#define GPIO_LATENCY_SAMPLES        100
+#define GPIO_LATENCY_TIMEOUT_US     10000
+#define GPIO_EDGE_BURST             1000    // edges per burst, even to end on the initial level
+#define GPIO_EDGE_DRAIN_MS          10      // time for pending interrupts after a burst
+
+// Variables
+volatile uint32_t isr_timestamp = 0;
+volatile bool isr_flag = false;
+volatile uint32_t isr_count = 0;
+
+static const PinStatus gpio_benchmark_modes[] = {RISING, FALLING, CHANGE};
+static const char *gpio_benchmark_mode_names[] = {"RISING", "FALLING", "CHANGE"};
+// Gap between two edges in us, from the slowest to the fastest burst
+static const uint16_t gpio_edge_gaps_us[] = {100, 50, 20, 10, 5, 2, 1, 0};
+
+#define GPIO_BENCHMARK_MODES (sizeof(gpio_benchmark_modes) / sizeof(gpio_benchmark_modes[0]))
+#define GPIO_EDGE_GAPS       (sizeof(gpio_edge_gaps_us) / sizeof(gpio_edge_gaps_us[0]))
+
+// Method invoked before a test suite is run.
+static void gpio_interrupts_benchmark_suite_setup() {
+
+}
+
+// Method invoked after a test suite is run.
+static void gpio_interrupts_benchmark_suite_teardown() {
+
+}
+
+// Test group name
+TEST_GROUP(gpio_interrupts_benchmark);
+TEST_GROUP(gpio_interrupts_benchmark_internal);
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(gpio_interrupts_benchmark_internal)
+{
+    pinMode(TEST_PIN_DIGITAL_IO_OUTPUT, OUTPUT);
+    pinMode(TEST_PIN_DIGITAL_IO_INPUT, INPUT);
+    isr_flag = false;
+    isr_count = 0;
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(gpio_interrupts_benchmark_internal) {
+    detachInterrupt(digitalPinToInterrupt(TEST_PIN_DIGITAL_IO_INPUT));
+}
+
+/**
+ * @brief Interrupt callback function storing the entry time.
+ */
+void latency_interrupt_callback() {
+    isr_timestamp = micros();
+    isr_flag = true;
+}
+
+/**
+ * @brief Interrupt callback function counting the edges.
+ */
+void count_interrupt_callback() {
+    isr_count++;
+}
+
+/**
+ * @brief Level the output rests on before an edge of the mode.
+ */
+static PinStatus gpio_benchmark_initial_level(PinStatus mode) {
+    return mode == FALLING ? HIGH : LOW;
+}
+
+/**
+ * @brief Interrupts expected for a burst of edges starting from the initial level.
+ */
+static uint32_t gpio_benchmark_expected_count(PinStatus mode, uint32_t edges) {
+    return mode == CHANGE ? edges : edges / 2;
+}
+
+/**
+ * @brief Test the latency from digitalWrite() to the ISR and from the ISR to the main loop.
+ */
+TEST_IFX(gpio_interrupts_benchmark_internal, test_interrupt_latency)
+{
+#ifdef TRACE_OUTPUT
+    Serial.println("\nmode\t\twrite to ISR mean/max us\tISR to main mean/max us");
+#endif
+    for (uint8_t m = 0; m < GPIO_BENCHMARK_MODES; m++) {
+        PinStatus mode = gpio_benchmark_modes[m];
+        PinStatus initial = gpio_benchmark_initial_level(mode);
+        RunningStats write_to_isr;
+        RunningStats isr_to_main;
+        uint16_t missed = 0;
+
+        digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, initial);
+        attachInterrupt(digitalPinToInterrupt(TEST_PIN_DIGITAL_IO_INPUT), latency_interrupt_callback, mode);
+
+        for (uint16_t n = 0; n < GPIO_LATENCY_SAMPLES; n++) {
+            digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, initial);
+            delayMicroseconds(100);
+            isr_flag = false;
+
+            uint32_t write_time = micros();
+            digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, initial == LOW ? HIGH : LOW); // triggers interrupt
+            while (!isr_flag && (micros() - write_time) < GPIO_LATENCY_TIMEOUT_US);
+            uint32_t main_time = micros();
+
+            if (!isr_flag) {
+                missed++;
+                continue;
+            }
+            write_to_isr.add(isr_timestamp - write_time);
+            isr_to_main.add(main_time - isr_timestamp);
+        }
+        detachInterrupt(digitalPinToInterrupt(TEST_PIN_DIGITAL_IO_INPUT));
+
+#ifdef TRACE_OUTPUT
+        Serial.print(gpio_benchmark_mode_names[m]);
+        Serial.print("\t\t");
+        Serial.print(write_to_isr.mean(), 2);
+        Serial.print(" / ");
+        Serial.print(write_to_isr.maximum(), 0);
+        Serial.print("\t\t\t");
+        Serial.print(isr_to_main.mean(), 2);
+        Serial.print(" / ");
+        Serial.println(isr_to_main.maximum(), 0);
+#endif
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, missed, "Interrupt should be triggered");
+    }
+}
+
+/**
+ * @brief Test the highest edge rate at which no edge is missed.
+ */
+TEST_IFX(gpio_interrupts_benchmark_internal, test_interrupt_max_edge_rate)
+{
+#ifdef TRACE_OUTPUT
+    Serial.println("\nmode\t\tgap us\tedges/s\t\texpected\tcounted");
+#endif
+    for (uint8_t m = 0; m < GPIO_BENCHMARK_MODES; m++) {
+        PinStatus mode = gpio_benchmark_modes[m];
+        PinStatus level = gpio_benchmark_initial_level(mode);
+        uint32_t expected = gpio_benchmark_expected_count(mode, GPIO_EDGE_BURST);
+        double max_edge_rate = 0.0;
+        bool slowest_lossless = false;
+
+        digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, level);
+        attachInterrupt(digitalPinToInterrupt(TEST_PIN_DIGITAL_IO_INPUT), count_interrupt_callback, mode);
+
+        for (uint8_t g = 0; g < GPIO_EDGE_GAPS; g++) {
+            uint16_t gap = gpio_edge_gaps_us[g];
+            delay(GPIO_EDGE_DRAIN_MS);
+            isr_count = 0;
+
+            uint32_t start = micros();
+            for (uint16_t n = 0; n < GPIO_EDGE_BURST; n++) {
+                level = level == LOW ? HIGH : LOW;
+                digitalWrite(TEST_PIN_DIGITAL_IO_OUTPUT, level);
+                if (gap > 0) {
+                    delayMicroseconds(gap);
+                }
+            }
+            uint32_t elapsed = micros() - start;
+            delay(GPIO_EDGE_DRAIN_MS);
+            uint32_t counted = isr_count;
+
+            double edge_rate = (double)GPIO_EDGE_BURST * MICROSECONDS_PER_SECOND / (elapsed > 0 ? elapsed : 1);
+            if (counted == expected) {
+                if (edge_rate > max_edge_rate) {
+                    max_edge_rate = edge_rate;
+                }
+                if (g == 0) {
+                    slowest_lossless = true;
+                }
+            }
+
+#ifdef TRACE_OUTPUT
+            Serial.print(gpio_benchmark_mode_names[m]);
+            Serial.print("\t\t");
+            Serial.print(gap);
+            Serial.print("\t");
+            Serial.print(edge_rate, 0);
+            Serial.print("\t\t");
+            Serial.print(expected);
+            Serial.print("\t\t");
+            Serial.println(counted);
+#endif
+        }
+        detachInterrupt(digitalPinToInterrupt(TEST_PIN_DIGITAL_IO_INPUT));
+
+#ifdef TRACE_OUTPUT
+        Serial.print(gpio_benchmark_mode_names[m]);
+        Serial.print(": highest edge rate without missed edges ");
+        Serial.print(max_edge_rate, 0);
+        Serial.println(" edges/s");
+#endif
+        TEST_ASSERT_TRUE_MESSAGE(slowest_lossless, "Edges missed at the slowest edge rate");
+    }
+}
+
+/**
+ * @brief Test group runner to run all test cases in this group.
+ */
+static TEST_GROUP_RUNNER(gpio_interrupts_benchmark_internal)
+{
+    RUN_TEST_CASE(gpio_interrupts_benchmark_internal, test_interrupt_latency);
+    RUN_TEST_CASE(gpio_interrupts_benchmark_internal, test_interrupt_max_edge_rate);
+}
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(gpio_interrupts_benchmark)
+{
+    gpio_interrupts_benchmark_suite_setup();
+
+    RUN_TEST_GROUP(gpio_interrupts_benchmark_internal);
+
+    gpio_interrupts_benchmark_suite_teardown();
+}
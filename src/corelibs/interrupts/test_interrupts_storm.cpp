@@ -0,0 +1,288 @@
+/* test_interrupts_storm.cpp
+ *
+ * This test verifies the GPIO Interrupts of several pins firing together while other
+ * interrupt sources are active.
+ * Every output pin of INTERRUPT_STORM_PINS should be connected to the input pin of its pair
+ * for the test cases to work as expected. By default only the TEST_PIN_DIGITAL_IO_OUTPUT and
+ * TEST_PIN_DIGITAL_IO_INPUT pair is used, the test_config.h of a board can list up to
+ * STORM_MAX_PINS pairs in INTERRUPT_STORM_PINS.
+ *
+ * The main loop toggles a pseudo random subset of the output pins back to back, so the
+ * interrupts of several pins are pending at the same time, for STORM_DURATION_MS. A pin is
+ * only toggled again STORM_EDGE_GAP_US after its previous edge, so a callback is only lost
+ * if the core drops or delays it beyond that gap. STORM_EDGE_GAP_US can be set in the
+ * test_config.h of a board, it has to be above the interrupt latency measured by
+ * test_interrupts_benchmark.cpp.
+ *
+ * Meanwhile STORM_UART transmits STORM_UART_BYTES_PER_ITERATION bytes per loop iteration
+ * and, if TEST_PIN_PULSE is available, tone() runs on it to keep a timer interrupt firing.
+ * STORM_UART is Serial1 if the core has it, the test_config.h of a board can name another
+ * port. Without a port the storm runs without UART load. The UART and the TEST_PIN_PULSE
+ * pin do not need to be connected.
+ *
+ * Every pin has its own CHANGE callback counting the edges and checking that the
+ * level alternates. Lost callbacks show as a count below the generated edges, duplicated
+ * ones as a count above them. A repeated level is only reported, it also shows callbacks
+ * running after the next edge of their pin.
+ *
+ * The main loop starvation is the longest time between two main loop iterations, compared
+ * to the same loop with the pin interrupts detached.
+ */
+
+#include "test_common_includes.h"
+#include "test_config.h"
+
+// Defines
+#define TRACE_OUTPUT
+#define STORM_MAX_PINS              4
+#define STORM_DURATION_MS           2000
+#define STORM_DRAIN_MS              10      // time for pending interrupts after the storm
+#define STORM_UART_BAUDRATE         115200
+#define STORM_UART_BYTES_PER_ITERATION 2   // bytes queued to STORM_UART per loop iteration
+#define STORM_TONE_FREQUENCY_HZ     10000
+#define STORM_MAX_STARVATION_US     10000
+#ifndef STORM_EDGE_GAP_US
+    #define STORM_EDGE_GAP_US       50      // minimum time between two edges of a pin
+#endif
+
+#if !defined(STORM_UART) && (defined(HAVE_HWSERIAL1) || defined(SERIAL_PORT_HARDWARE1))
+    #define STORM_UART              Serial1
+#endif
+
+#ifndef INTERRUPT_STORM_PINS
+    #define INTERRUPT_STORM_PINS {{TEST_PIN_DIGITAL_IO_OUTPUT, TEST_PIN_DIGITAL_IO_INPUT}}
+#endif
+
+// Variables
+static const uint8_t storm_pins[][2] = INTERRUPT_STORM_PINS;   // output, input
+
+#define STORM_PINS (sizeof(storm_pins) / sizeof(storm_pins[0]))
+static_assert(STORM_PINS <= STORM_MAX_PINS, "Too many pins in INTERRUPT_STORM_PINS");
+
+volatile uint32_t storm_callbacks[STORM_MAX_PINS];   // Callbacks per pin
+volatile uint32_t storm_repeated[STORM_MAX_PINS];    // Callbacks reading the level of the previous one
+volatile uint8_t storm_last_level[STORM_MAX_PINS];   // Level read by the previous callback
+static uint32_t storm_generated[STORM_MAX_PINS];     // Edges generated per pin
+static uint8_t storm_output_level[STORM_MAX_PINS];
+
+static uint32_t storm_random = 0x1234567;
+
+#ifdef STORM_UART
+static const uint8_t storm_uart_pattern[] = "interrupt storm 0123456789 abcdefghijklmnopqrstuvwxyz\r\n";
+#endif
+
+// Method invoked before a test suite is run.
+static void gpio_interrupts_storm_suite_setup() {
+#ifdef STORM_UART
+    STORM_UART.begin(STORM_UART_BAUDRATE);
+#endif
+}
+
+// Method invoked after a test suite is run.
+static void gpio_interrupts_storm_suite_teardown() {
+#ifdef STORM_UART
+    STORM_UART.end();
+#endif
+}
+
+// Test group name
+TEST_GROUP(gpio_interrupts_storm);
+TEST_GROUP(gpio_interrupts_storm_internal);
+
+/**
+ * @brief Count the callback of a pin and check the level alternates.
+ */
+static void storm_record(uint8_t index) {
+    uint8_t level = digitalRead(storm_pins[index][1]);
+    if (level == storm_last_level[index]) {
+        storm_repeated[index]++;
+    }
+    storm_last_level[index] = level;
+    storm_callbacks[index]++;
+}
+
+/**
+ * @brief Interrupt callback functions, one per pin.
+ */
+void storm_callback_0() { storm_record(0); }
+void storm_callback_1() { storm_record(1); }
+void storm_callback_2() { storm_record(2); }
+void storm_callback_3() { storm_record(3); }
+
+static void (*const storm_callbacks_table[STORM_MAX_PINS])() = {
+    storm_callback_0, storm_callback_1, storm_callback_2, storm_callback_3
+};
+
+/**
+ * @brief Setup method called by Unity before every test in this test group.
+ */
+static TEST_SETUP(gpio_interrupts_storm_internal)
+{
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        pinMode(storm_pins[i][0], OUTPUT);
+        pinMode(storm_pins[i][1], INPUT);
+        digitalWrite(storm_pins[i][0], LOW);
+        storm_output_level[i] = LOW;
+        storm_last_level[i] = LOW;
+        storm_callbacks[i] = 0;
+        storm_repeated[i] = 0;
+        storm_generated[i] = 0;
+    }
+}
+
+/**
+ * @brief Tear down method called by Unity after every test in this test group.
+ */
+static TEST_TEAR_DOWN(gpio_interrupts_storm_internal) {
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        detachInterrupt(digitalPinToInterrupt(storm_pins[i][1]));
+    }
+#ifdef TEST_PIN_PULSE
+    noTone(TEST_PIN_PULSE);
+#endif
+}
+
+/**
+ * @brief Run the storm loop for STORM_DURATION_MS.
+ *
+ * @param starvation Longest time between two loop iterations in us.
+ * @return Loop iterations.
+ */
+static uint32_t storm_loop(uint32_t *starvation) {
+    uint32_t iterations = 0;
+#ifdef STORM_UART
+    size_t uart_index = 0;
+#endif
+    uint32_t longest = 0;
+    uint32_t start = micros();
+    uint32_t last = start;
+    uint32_t edge_us[STORM_MAX_PINS];   // Time after the last edge per pin
+
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        edge_us[i] = start - STORM_EDGE_GAP_US;
+    }
+
+    while ((last - start) < STORM_DURATION_MS * 1000UL) {
+        // xorshift, one bit per pin selects the pins toggled together
+        storm_random ^= storm_random << 13;
+        storm_random ^= storm_random >> 17;
+        storm_random ^= storm_random << 5;
+        uint8_t toggled = 0;
+        for (uint8_t i = 0; i < STORM_PINS; i++) {
+            if ((storm_random & (1UL << i)) && (last - edge_us[i]) >= STORM_EDGE_GAP_US) {
+                storm_output_level[i] = storm_output_level[i] == LOW ? HIGH : LOW;
+                digitalWrite(storm_pins[i][0], storm_output_level[i]);
+                storm_generated[i]++;
+                toggled |= 1 << i;
+            }
+        }
+
+#ifdef STORM_UART
+        // Keep the UART transmitter busy, availableForWrite() is 0 on some cores
+        for (uint8_t n = 0; n < STORM_UART_BYTES_PER_ITERATION; n++) {
+            STORM_UART.write(storm_uart_pattern[uart_index]);
+            uart_index = (uart_index + 1) % (sizeof(storm_uart_pattern) - 1);
+        }
+#endif
+
+        uint32_t now = micros();
+        for (uint8_t i = 0; i < STORM_PINS; i++) {
+            if (toggled & (1 << i)) {
+                edge_us[i] = now;
+            }
+        }
+        if (now - last > longest) {
+            longest = now - last;
+        }
+        last = now;
+        iterations++;
+    }
+
+    *starvation = longest;
+    return iterations;
+}
+
+/**
+ * @brief Test overlapping edges on all pins with UART and timer interrupts active.
+ */
+TEST_IFX(gpio_interrupts_storm_internal, test_interrupt_storm)
+{
+#ifdef TEST_PIN_PULSE
+    tone(TEST_PIN_PULSE, STORM_TONE_FREQUENCY_HZ);
+#endif
+
+    // Reference without the pin interrupts
+    uint32_t quiet_starvation = 0;
+    uint32_t quiet_iterations = storm_loop(&quiet_starvation);
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        digitalWrite(storm_pins[i][0], LOW);
+        storm_output_level[i] = LOW;
+        storm_generated[i] = 0;
+    }
+    delay(STORM_DRAIN_MS);
+
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        attachInterrupt(digitalPinToInterrupt(storm_pins[i][1]), storm_callbacks_table[i], CHANGE);
+    }
+
+    uint32_t storm_starvation = 0;
+    uint32_t storm_iterations = storm_loop(&storm_starvation);
+    delay(STORM_DRAIN_MS);
+
+#ifdef TRACE_OUTPUT
+    Serial.print("\nMain loop: ");
+    Serial.print(quiet_iterations);
+    Serial.print(" iterations, longest gap ");
+    Serial.print(quiet_starvation);
+    Serial.println(" us without pin interrupts");
+    Serial.print("Main loop: ");
+    Serial.print(storm_iterations);
+    Serial.print(" iterations, longest gap ");
+    Serial.print(storm_starvation);
+    Serial.println(" us during the storm");
+    Serial.println("pin\tgenerated\tcallbacks\trepeated level");
+#endif
+    uint32_t lost = 0;
+    uint32_t duplicated = 0;
+    for (uint8_t i = 0; i < STORM_PINS; i++) {
+        uint32_t callbacks = storm_callbacks[i];
+        if (callbacks < storm_generated[i]) {
+            lost += storm_generated[i] - callbacks;
+        } else {
+            duplicated += callbacks - storm_generated[i];
+        }
+#ifdef TRACE_OUTPUT
+        Serial.print(storm_pins[i][1]);
+        Serial.print("\t");
+        Serial.print(storm_generated[i]);
+        Serial.print("\t\t");
+        Serial.print(callbacks);
+        Serial.print("\t\t");
+        Serial.println(storm_repeated[i]);
+#endif
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, lost, "Callbacks lost");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, duplicated, "Callbacks duplicated");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(STORM_MAX_STARVATION_US, storm_starvation, "Main loop starved");
+}
+
+/**
+ * @brief Test group runner to run all test cases in this group.
+ */
+static TEST_GROUP_RUNNER(gpio_interrupts_storm_internal)
+{
+    RUN_TEST_CASE(gpio_interrupts_storm_internal, test_interrupt_storm);
+}
+
+/**
+ * @brief Bundle all tests to be executed for this test group.
+ */
+TEST_GROUP_RUNNER(gpio_interrupts_storm)
+{
+    gpio_interrupts_storm_suite_setup();
+
+    RUN_TEST_GROUP(gpio_interrupts_storm_internal);
+
+    gpio_interrupts_storm_suite_teardown();
+}
@@ -0,0 +1,299 @@
+/**
+ * @brief This test starts an access point with a WiFi (TCP) server which serves
+ * traffic to several associated stations concurrently, each station running the
+ * "test_wifi_ap_load_station.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Calibrate the idle CPU meter with the unloaded loop
+ * - Start the access point
+ * - Start the server
+ * - Accept the stations: every station announces itself with one byte after
+ *   connecting. Stations are accepted until none joined for AP_LOAD_JOIN_WINDOW_MS.
+ * - Run one load phase of AP_LOAD_PHASE_MS per station count k = 1..stations,
+ *   streaming to the first k stations in parallel from one loop
+ * - Report per phase the aggregate and per-station throughput, the fairness
+ *   between the stations, the idle CPU headroom and the heap used by the load
+ * - Stop the stations, stop the server
+ * - Disconnect the WiFi connection
+ * - End the WiFi
+ *
+ * The data is sent in chunks of AP_LOAD_CHUNK_SIZE bytes and every station
+ * acknowledges each AP_LOAD_ACK_BYTES bytes it received with one byte. The throughput
+ * is the data the stations acknowledged within the phase, i.e. the bytes they actually
+ * received. At most AP_LOAD_WINDOW_BYTES are in flight per station, well above the TCP
+ * window, so the acknowledges only keep a stalled station from queueing without limit
+ * and the rate is set by the link, not by the acknowledge round trip. The fairness is Jain's index of the per-station throughput:
+ * (sum x)^2 / (k * sum x^2), 1.0 when all stations get the same share.
+ *
+ * This test is paired in the "test_wifi_ap_load_station.cpp" test, which needs to be
+ * executed in one or more further boards, each one being a station of the access point.
+ *
+ * @note This test must be run before the "test_wifi_ap_load_station.cpp" tests.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiServer.h>
+
+#define AP_LOAD_PORT                5009
+#define AP_LOAD_MAX_STATIONS        8
+#define AP_LOAD_CHUNK_SIZE          512
+#define AP_LOAD_ACK_BYTES           4096  // bytes acknowledged by one byte of the station
+#define AP_LOAD_WINDOW_BYTES        65536 // bytes in flight per station
+#define AP_LOAD_PATTERN_PERIOD      251
+#define AP_LOAD_PHASE_MS            2000
+#define AP_LOAD_JOIN_WINDOW_MS      3000
+#define AP_LOAD_TIMEOUT_MS          120000
+#define AP_LOAD_CALIBRATION_MS      500
+#define AP_LOAD_HEAP_SAMPLE_LOOPS   256
+#define AP_LOAD_MIN_FAIRNESS        0.8
+
+TEST_GROUP(wifi_ap_load_server);
+
+static TEST_SETUP(wifi_ap_load_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_ap_load_server) {
+}
+
+WiFiServer server;
+
+typedef struct {
+    WiFiClient client;
+    IPAddress ip;
+    uint32_t offset;    // stream offset of the next chunk
+    uint32_t sent;      // bytes sent in the phase
+    uint32_t acked;     // bytes acknowledged in the phase
+} ap_load_station_t;
+
+typedef struct {
+    uint8_t stations;
+    double aggregateKBps;
+    double fairness;
+    double headroom;
+    long heapLoad;
+} ap_load_phase_t;
+
+static ap_load_station_t stations[AP_LOAD_MAX_STATIONS];
+static ap_load_phase_t phases[AP_LOAD_MAX_STATIONS];
+static uint8_t stationCount = 0;
+static IdleMeter idleMeter;
+static size_t heapBaseline = 0;
+
+/* Stream content shared with the station, built once so that
+no time of the phases goes into generating it */
+static uint8_t streamPattern[AP_LOAD_PATTERN_PERIOD + AP_LOAD_CHUNK_SIZE];
+
+static void buildStreamPattern() {
+    for (size_t i = 0; i < sizeof(streamPattern); i++) {
+        streamPattern[i] = (uint8_t)(i % AP_LOAD_PATTERN_PERIOD);
+    }
+}
+
+/**
+ * @brief Count the acknowledges received from a station without waiting.
+ */
+static void drainAcks(ap_load_station_t &s) {
+    uint8_t acks[16];
+
+    int avail = s.client.available();
+    if (avail <= 0) {
+        return;
+    }
+    int read_bytes = s.client.read(acks, (size_t)avail < sizeof(acks) ? (size_t)avail : sizeof(acks));
+    if (read_bytes > 0) {
+        s.acked += read_bytes * AP_LOAD_ACK_BYTES;
+    }
+}
+
+static void sendChunk(ap_load_station_t &s) {
+    const uint8_t *chunk = streamPattern + s.offset % AP_LOAD_PATTERN_PERIOD;
+    TEST_ASSERT_EQUAL_INT(AP_LOAD_CHUNK_SIZE, s.client.write(chunk, AP_LOAD_CHUNK_SIZE));
+    s.offset += AP_LOAD_CHUNK_SIZE;
+    s.sent += AP_LOAD_CHUNK_SIZE;
+}
+
+/**
+ * @brief Stream to the first count stations for AP_LOAD_PHASE_MS.
+ */
+static void runPhase(uint8_t count) {
+    ap_load_phase_t &phase = phases[count - 1];
+    uint32_t ackedInTime[AP_LOAD_MAX_STATIONS];
+    size_t heapPeak = heapUsedBytes();
+    uint32_t loops = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        stations[i].sent = 0;
+        stations[i].acked = 0;
+    }
+
+    idleMeter.start();
+    uint32_t start = millis();
+    while ((millis() - start) < AP_LOAD_PHASE_MS) {
+        for (uint8_t i = 0; i < count; i++) {
+            ap_load_station_t &s = stations[i];
+            drainAcks(s);
+            if ((s.sent - s.acked) < AP_LOAD_WINDOW_BYTES) {
+                sendChunk(s);
+            }
+        }
+        if ((++loops % AP_LOAD_HEAP_SAMPLE_LOOPS) == 0) {
+            size_t heap = heapUsedBytes();
+            if (heap > heapPeak) {
+                heapPeak = heap;
+            }
+        }
+        idleMeter.work();
+    }
+    uint32_t elapsed = millis() - start;
+    phase.headroom = idleMeter.headroomPercent();
+
+    for (uint8_t i = 0; i < count; i++) {
+        ackedInTime[i] = stations[i].acked;
+    }
+
+    /* Complete the last acknowledge unit and let the data in
+    flight arrive, so that the next phase starts with empty windows */
+    start = millis();
+    for (uint8_t i = 0; i < count; i++) {
+        ap_load_station_t &s = stations[i];
+        while ((s.sent % AP_LOAD_ACK_BYTES) != 0) {
+            sendChunk(s);
+        }
+        while (s.acked < s.sent) {
+            TEST_ASSERT_TRUE_MESSAGE((millis() - start) < AP_LOAD_TIMEOUT_MS, "Chunks not acknowledged");
+            drainAcks(s);
+        }
+    }
+
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    Serial.print("\nLoad phase with ");
+    Serial.print(count);
+    Serial.println(" station(s)");
+    for (uint8_t i = 0; i < count; i++) {
+        double kBps = (double)ackedInTime[i] / elapsed;
+        sum += kBps;
+        sumSquares += kBps * kBps;
+        Serial.print("  station ");
+        Serial.print(stations[i].ip.toString());
+        Serial.print(": ");
+        Serial.print(kBps, 1);
+        Serial.println(" kB/s");
+    }
+
+    phase.stations = count;
+    phase.aggregateKBps = sum;
+    phase.fairness = sumSquares > 0.0 ? (sum * sum) / (count * sumSquares) : 0.0;
+    phase.heapLoad = (long)heapPeak - (long)heapBaseline;
+}
+
+TEST_IFX(wifi_ap_load_server, idle_calibrate) {
+    idleMeter.calibrate(AP_LOAD_CALIBRATION_MS);
+    Serial.print("\nIdle loop baseline: ");
+    Serial.print(idleMeter.baseline(), 0);
+    Serial.println(" work units/s");
+    TEST_ASSERT_TRUE(idleMeter.baseline() > 0);
+}
+
+TEST_IFX(wifi_ap_load_server, wifi_begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_ap_load_server, server_begin) {
+    server.begin(AP_LOAD_PORT);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_LISTENING, server.status());
+    heapBaseline = heapUsedBytes();
+}
+
+TEST_IFX(wifi_ap_load_server, server_accept_stations) {
+    uint32_t start = millis();
+    uint32_t lastJoin = millis();
+
+    while (stationCount == 0 || (millis() - lastJoin) < AP_LOAD_JOIN_WINDOW_MS) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < AP_LOAD_TIMEOUT_MS, "No station connected");
+
+        /* Every station sends one byte after connecting,
+        which makes it available exactly once */
+        WiFiClient client = server.available();
+        if (!client || stationCount >= AP_LOAD_MAX_STATIONS) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL_INT('H', client.read());
+
+        ap_load_station_t &s = stations[stationCount++];
+        s.client = client;
+        s.ip = client.remoteIP();
+        s.offset = 0;
+        lastJoin = millis();
+    }
+
+    Serial.print("\nAssociated stations: ");
+    Serial.println(WiFi.connected());
+    Serial.print("Connected stations: ");
+    Serial.println(stationCount);
+    Serial.print("Heap per connected station: ");
+    Serial.print(((long)heapUsedBytes() - (long)heapBaseline) / stationCount);
+    Serial.println(" bytes");
+
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT8(stationCount, WiFi.connected());
+}
+
+TEST_IFX(wifi_ap_load_server, server_load_stations) {
+    buildStreamPattern();
+    for (uint8_t count = 1; count <= stationCount; count++) {
+        runPhase(count);
+    }
+}
+
+TEST_IFX(wifi_ap_load_server, server_report_load) {
+    Serial.println("\nstations\taggregate kB/s\tper station kB/s\tfairness\theadroom %\theap bytes");
+    for (uint8_t i = 0; i < stationCount; i++) {
+        const ap_load_phase_t &phase = phases[i];
+        Serial.print(phase.stations);
+        Serial.print("\t\t");
+        Serial.print(phase.aggregateKBps, 1);
+        Serial.print("\t\t");
+        Serial.print(phase.aggregateKBps / phase.stations, 1);
+        Serial.print("\t\t\t");
+        Serial.print(phase.fairness, 3);
+        Serial.print("\t\t");
+        Serial.print(phase.headroom, 1);
+        Serial.print("\t\t");
+        Serial.println(phase.heapLoad);
+
+        TEST_ASSERT_TRUE_MESSAGE(phase.aggregateKBps > 0, "No data acknowledged");
+        TEST_ASSERT_TRUE_MESSAGE(phase.fairness >= AP_LOAD_MIN_FAIRNESS, "Unfair share between the stations");
+    }
+}
+
+TEST_IFX(wifi_ap_load_server, server_end) {
+    for (uint8_t i = 0; i < stationCount; i++) {
+        stations[i].client.stop();
+    }
+    server.end();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, server.status());
+}
+
+TEST_IFX(wifi_ap_load_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_ap_load_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_UINT8(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_ap_load_server) {
+    RUN_TEST_CASE(wifi_ap_load_server, idle_calibrate);
+    RUN_TEST_CASE(wifi_ap_load_server, wifi_begin_ap);
+    RUN_TEST_CASE(wifi_ap_load_server, server_begin);
+    RUN_TEST_CASE(wifi_ap_load_server, server_accept_stations);
+    RUN_TEST_CASE(wifi_ap_load_server, server_load_stations);
+    RUN_TEST_CASE(wifi_ap_load_server, server_report_load);
+    RUN_TEST_CASE(wifi_ap_load_server, server_end);
+    RUN_TEST_CASE(wifi_ap_load_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_ap_load_server, wifi_end);
+}
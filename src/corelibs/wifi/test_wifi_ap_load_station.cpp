@@ -0,0 +1,154 @@
+/**
+ * @brief This test is one station of the access point load test: it receives the
+ * stream the "test_wifi_ap_load_server.cpp" test serves to all its stations.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_ap_load_server.cpp test
+ * - Connect to the server and announce the station with one byte
+ * - Receive the stream until the server closes the connection: every byte is
+ *   verified and every AP_LOAD_ACK_BYTES bytes are acknowledged with 'K'
+ * - Report the received bytes and the throughput while receiving
+ * - Stop the client, disconnect the wifi connection and end the WiFi
+ *
+ * The access point runs one load phase per station count, so depending on its
+ * join order the station is idle during the first phases.
+ *
+ * This test is paired in the "test_wifi_ap_load_server.cpp" test, which needs to be
+ * executed in a second board to provide the access point. Further boards running
+ * this test add stations to the load.
+ *
+ * @note This test must be run after the "test_wifi_ap_load_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#define AP_LOAD_PORT                5009
+#define AP_LOAD_CHUNK_SIZE          512
+#define AP_LOAD_ACK_BYTES           4096  // bytes acknowledged by one byte to the server
+#define AP_LOAD_PATTERN_PERIOD      251
+#define AP_LOAD_TIMEOUT_MS          120000
+#define AP_LOAD_IDLE_GAP_MS         100   // gap between two phases of this station
+
+TEST_GROUP(wifi_ap_load_station);
+
+static TEST_SETUP(wifi_ap_load_station) {
+}
+
+static TEST_TEAR_DOWN(wifi_ap_load_station) {
+}
+
+WiFiClient client;
+
+static uint32_t received = 0;
+static uint32_t errors = 0;
+static uint32_t activeUs = 0;
+
+/* Stream content shared with the access point */
+static uint8_t streamPattern[AP_LOAD_PATTERN_PERIOD + AP_LOAD_CHUNK_SIZE];
+
+static void buildStreamPattern() {
+    for (size_t i = 0; i < sizeof(streamPattern); i++) {
+        streamPattern[i] = (uint8_t)(i % AP_LOAD_PATTERN_PERIOD);
+    }
+}
+
+TEST_IFX(wifi_ap_load_station, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_ap_load_station, client_connect) {
+    IPAddress ip(192, 168, 0, 1);
+    TEST_ASSERT_TRUE(client.connect(ip, AP_LOAD_PORT));
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_CONNECTED, client.status());
+    TEST_ASSERT_EQUAL_INT(1, client.write('H'));
+}
+
+TEST_IFX(wifi_ap_load_station, client_receive_stream) {
+    uint8_t buf[AP_LOAD_CHUNK_SIZE];
+    uint32_t lastData = millis();
+    uint32_t lastDataUs = 0;
+    bool receiving = false;
+
+    buildStreamPattern();
+    while (true) {
+        int avail = client.available();
+        if (avail <= 0) {
+            if (!client.connected()) {
+                break;
+            }
+            TEST_ASSERT_TRUE_MESSAGE((millis() - lastData) < AP_LOAD_TIMEOUT_MS, "Stream stalled");
+            continue;
+        }
+
+        int read_bytes = client.read(buf, (size_t)avail < sizeof(buf) ? (size_t)avail : sizeof(buf));
+        if (read_bytes <= 0) {
+            continue;
+        }
+
+        /* Only the time with data flowing counts, the
+        phases this station is not loaded are skipped */
+        uint32_t nowUs = micros();
+        if (receiving && (millis() - lastData) < AP_LOAD_IDLE_GAP_MS) {
+            activeUs += nowUs - lastDataUs;
+        }
+        receiving = true;
+        lastDataUs = nowUs;
+        lastData = millis();
+
+        if (memcmp(buf, streamPattern + received % AP_LOAD_PATTERN_PERIOD, read_bytes) != 0) {
+            errors++;
+        }
+        uint32_t acks = (received + read_bytes) / AP_LOAD_ACK_BYTES - received / AP_LOAD_ACK_BYTES;
+        received += read_bytes;
+        while (acks-- > 0) {
+            client.write('K');
+        }
+    }
+}
+
+TEST_IFX(wifi_ap_load_station, client_report_stream) {
+    Serial.print("\nStation ");
+    Serial.print(WiFi.localIP().toString());
+    Serial.print(" received: ");
+    Serial.print(received);
+    Serial.println(" bytes");
+    if (activeUs > 0) {
+        Serial.print("Throughput while receiving: ");
+        Serial.print((double)received * 1000.0 / activeUs, 1);
+        Serial.println(" kB/s");
+    }
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, received);
+    TEST_ASSERT_EQUAL_UINT32(0, received % AP_LOAD_ACK_BYTES);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, "Stream content corrupted");
+}
+
+TEST_IFX(wifi_ap_load_station, client_stop) {
+    client.stop();
+    TEST_ASSERT_FALSE(client.connected());
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, client.status());
+}
+
+TEST_IFX(wifi_ap_load_station, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_ap_load_station, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_ap_load_station) {
+    RUN_TEST_CASE(wifi_ap_load_station, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_ap_load_station, client_connect);
+    RUN_TEST_CASE(wifi_ap_load_station, client_receive_stream);
+    RUN_TEST_CASE(wifi_ap_load_station, client_report_stream);
+    RUN_TEST_CASE(wifi_ap_load_station, client_stop);
+    RUN_TEST_CASE(wifi_ap_load_station, wifi_disconnect);
+    RUN_TEST_CASE(wifi_ap_load_station, wifi_end);
+}
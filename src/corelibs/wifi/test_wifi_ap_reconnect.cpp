@@ -0,0 +1,100 @@
+/**
+ * @brief This test sets up the WiFi access point and the UDP echo used by the
+ * connect/reconnect latency profiler of the "test_wifi_sta_reconnect.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Start the access point
+ * - Start the UDP echo at port RECONNECT_ECHO_PORT
+ * - Echo every datagram of the station until it sends the quit request,
+ *   and report the number of echoed probes
+ * - Stop the UDP echo and the access point
+ *
+ * This test is paired with the "test_wifi_sta_reconnect.cpp" test, which
+ * running on a second board will repeatedly connect to the AP created by this test.
+ *
+ * @note This test must be run before the "test_wifi_sta_reconnect.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define RECONNECT_ECHO_PORT         5006
+#define RECONNECT_IDLE_TIMEOUT_MS   120000
+
+TEST_GROUP(wifi_ap_reconnect);
+
+static TEST_SETUP(wifi_ap_reconnect) {
+}
+
+static TEST_TEAR_DOWN(wifi_ap_reconnect) {
+}
+
+WiFiUDP udpEcho;
+
+TEST_IFX(wifi_ap_reconnect, begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_ap_reconnect, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpEcho.begin(RECONNECT_ECHO_PORT));
+}
+
+TEST_IFX(wifi_ap_reconnect, echo_probes) {
+    uint8_t probe[16];
+    uint32_t echoed = 0;
+    uint32_t lastPacket = millis();
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastPacket) < RECONNECT_IDLE_TIMEOUT_MS, "No probe from station");
+
+        int packetSize = udpEcho.parsePacket();
+        if (packetSize <= 0) {
+            continue;
+        }
+        lastPacket = millis();
+
+        int read_bytes = udpEcho.read(probe, sizeof(probe));
+        if (read_bytes > 0 && probe[0] == 'Q') {
+            quit = true;
+            continue;
+        }
+
+        if (udpEcho.beginPacket(udpEcho.remoteIP(), udpEcho.remotePort())) {
+            udpEcho.write(probe, read_bytes);
+            if (udpEcho.endPacket()) {
+                echoed++;
+            }
+        }
+    }
+
+    Serial.print("\nEchoed probes: ");
+    Serial.println(echoed);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, echoed);
+}
+
+TEST_IFX(wifi_ap_reconnect, udp_end) {
+    udpEcho.stop();
+}
+
+TEST_IFX(wifi_ap_reconnect, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_ap_reconnect, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_ap_reconnect) {
+    RUN_TEST_CASE(wifi_ap_reconnect, begin_ap);
+    RUN_TEST_CASE(wifi_ap_reconnect, udp_begin);
+    RUN_TEST_CASE(wifi_ap_reconnect, echo_probes);
+    RUN_TEST_CASE(wifi_ap_reconnect, udp_end);
+    RUN_TEST_CASE(wifi_ap_reconnect, wifi_disconnect);
+    RUN_TEST_CASE(wifi_ap_reconnect, wifi_end);
+}
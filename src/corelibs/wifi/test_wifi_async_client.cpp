@@ -0,0 +1,263 @@
+/**
+ * @brief This test drives many WiFi (TCP) clients from a single non-blocking loop
+ * and measures the idle CPU headroom left to the application meanwhile.
+ *
+ * @details The tests runs the following sequence:
+ * - Calibrate the idle CPU meter with the unloaded loop
+ * - Connect to the access point created by the test_wifi_async_server.cpp test
+ * - Connect ASYNC_CLIENTS clients to the echo server
+ * - Exchange ASYNC_ROUNDS ping/echo rounds per client, all clients in parallel
+ *   from one loop which never waits for a single client
+ * - Report the loop iterations and the CPU headroom of every phase
+ * - Stop the clients, disconnect the wifi connection and end the WiFi
+ *
+ * With a core defining ARDUINO_WIFI_ASYNC_API, the phases use the proposed
+ * asynchronous API:
+ *
+ *   int WiFi.beginAsync(const char *ssid, const char *passphrase);
+ *   int WiFiClient::connectAsync(IPAddress ip, uint16_t port);
+ *   void WiFiClient::onReceive(void (*callback)(void *arg), void *arg);
+ *
+ * - beginAsync() and connectAsync() start the connection and return 1 immediately,
+ *   or 0 if it cannot be started. The completion is polled with WiFi.status() and
+ *   client.connected().
+ * - The onReceive() callback is invoked whenever new data arrives for the client.
+ *   It may run in the context of the network stack and must not block.
+ *
+ * Without it, the connections use the blocking begin() and connect(), and the data
+ * is polled with available(). The headroom of the connect phases then shows the
+ * cost of blocking.
+ *
+ * This test is paired in the "test_wifi_async_server.cpp" test, which needs to be
+ * executed in a second board to provide the echo server.
+ *
+ * @note This test must be run after the "test_wifi_async_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#define ASYNC_PORT                  5007
+#define ASYNC_CLIENTS               8
+#define ASYNC_ROUNDS                20
+#define ASYNC_MSG_SIZE              16
+#define ASYNC_START_MAX_MS          50
+#define ASYNC_TIMEOUT_MS            30000
+#define ASYNC_CALIBRATION_MS        500
+
+TEST_GROUP(wifi_async_client);
+
+static TEST_SETUP(wifi_async_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_async_client) {
+}
+
+static WiFiClient clients[ASYNC_CLIENTS];
+static IdleMeter idleMeter;
+
+typedef struct {
+    volatile uint32_t events;   // onReceive() invocations
+    uint32_t handledEvents;
+    uint16_t round;
+    uint8_t received;
+    uint8_t expected[ASYNC_MSG_SIZE];
+} async_client_state_t;
+
+static async_client_state_t state[ASYNC_CLIENTS];
+
+#ifdef ARDUINO_WIFI_ASYNC_API
+static void onReceiveAsync(void *arg) {
+    async_client_state_t *s = (async_client_state_t *)arg;
+    s->events++;
+}
+#endif
+
+static void printPhase(const char *title, uint32_t elapsedMs, uint32_t loops) {
+    Serial.print("\n");
+    Serial.print(title);
+    Serial.print(": ");
+    Serial.print(elapsedMs);
+    Serial.print(" ms, ");
+    Serial.print(loops);
+    Serial.print(" loop iterations, headroom ");
+    Serial.print(idleMeter.headroomPercent(), 1);
+    Serial.println(" %");
+}
+
+static void sendPing(uint8_t index) {
+    async_client_state_t &s = state[index];
+
+    for (uint8_t i = 0; i < ASYNC_MSG_SIZE; i++) {
+        s.expected[i] = (uint8_t)(index * 31 + s.round * 7 + i);
+    }
+    s.received = 0;
+    TEST_ASSERT_EQUAL_INT(ASYNC_MSG_SIZE, clients[index].write(s.expected, ASYNC_MSG_SIZE));
+}
+
+/**
+ * @brief Consume the available echo data of a client without waiting.
+ *
+ * @return true once the echo of the current round is complete.
+ */
+static bool pollEcho(uint8_t index) {
+    async_client_state_t &s = state[index];
+    uint8_t buf[ASYNC_MSG_SIZE];
+
+    int avail = clients[index].available();
+    if (avail <= 0) {
+        return false;
+    }
+    int request = ASYNC_MSG_SIZE - s.received;
+    if (avail < request) {
+        request = avail;
+    }
+    int read_bytes = clients[index].read(buf, request);
+    for (int i = 0; i < read_bytes; i++) {
+        TEST_ASSERT_EQUAL_UINT8(s.expected[s.received + i], buf[i]);
+    }
+    if (read_bytes > 0) {
+        s.received += read_bytes;
+    }
+    return s.received == ASYNC_MSG_SIZE;
+}
+
+TEST_IFX(wifi_async_client, idle_calibrate) {
+    idleMeter.calibrate(ASYNC_CALIBRATION_MS);
+    Serial.print("\nIdle loop baseline: ");
+    Serial.print(idleMeter.baseline(), 0);
+    Serial.println(" work units/s");
+    TEST_ASSERT_TRUE(idleMeter.baseline() > 0);
+}
+
+TEST_IFX(wifi_async_client, wifi_connect_to_ap) {
+    uint32_t loops = 0;
+
+    idleMeter.start();
+    uint32_t start = millis();
+#ifdef ARDUINO_WIFI_ASYNC_API
+    TEST_ASSERT_EQUAL_INT(1, WiFi.beginAsync("arduino-wifi-ap", "wifi-ap-password"));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ASYNC_START_MAX_MS, millis() - start);
+
+    while (WiFi.status() != WL_CONNECTED) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < ASYNC_TIMEOUT_MS, "WiFi not connected");
+        idleMeter.work();
+        loops++;
+    }
+#else
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, WiFi.begin("arduino-wifi-ap", "wifi-ap-password"));
+#endif
+    printPhase("WiFi connect", millis() - start, loops);
+}
+
+TEST_IFX(wifi_async_client, clients_connect) {
+    IPAddress ip(192, 168, 0, 1);
+    uint32_t loops = 0;
+    uint8_t connected = 0;
+
+    idleMeter.start();
+    uint32_t start = millis();
+#ifdef ARDUINO_WIFI_ASYNC_API
+    for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+        clients[i].onReceive(onReceiveAsync, &state[i]);
+        TEST_ASSERT_EQUAL_INT(1, clients[i].connectAsync(ip, ASYNC_PORT));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ASYNC_START_MAX_MS, millis() - start);
+
+    while (connected < ASYNC_CLIENTS) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < ASYNC_TIMEOUT_MS, "Clients not connected");
+        connected = 0;
+        for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+            connected += clients[i].connected() ? 1 : 0;
+        }
+        idleMeter.work();
+        loops++;
+    }
+#else
+    for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+        TEST_ASSERT_TRUE(clients[i].connect(ip, ASYNC_PORT));
+        connected++;
+    }
+#endif
+    printPhase("Clients connect", millis() - start, loops);
+    TEST_ASSERT_EQUAL_UINT8(ASYNC_CLIENTS, connected);
+}
+
+TEST_IFX(wifi_async_client, clients_exchange) {
+    uint32_t loops = 0;
+    uint8_t finished = 0;
+
+    for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+        sendPing(i);
+    }
+
+    idleMeter.start();
+    uint32_t start = millis();
+    while (finished < ASYNC_CLIENTS) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < ASYNC_TIMEOUT_MS, "Echo rounds not completed");
+
+        for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+            async_client_state_t &s = state[i];
+            if (s.round >= ASYNC_ROUNDS) {
+                continue;
+            }
+#ifdef ARDUINO_WIFI_ASYNC_API
+            /* Only clients signalled by their callback are served */
+            if (s.events == s.handledEvents) {
+                continue;
+            }
+            s.handledEvents = s.events;
+#endif
+            if (pollEcho(i)) {
+                s.round++;
+                if (s.round < ASYNC_ROUNDS) {
+                    sendPing(i);
+                } else {
+                    finished++;
+                }
+            }
+        }
+        idleMeter.work();
+        loops++;
+    }
+    uint32_t elapsed = millis() - start;
+
+    printPhase("Echo rounds", elapsed, loops);
+    Serial.print("Rounds per second: ");
+    Serial.println(elapsed > 0 ? (double)ASYNC_CLIENTS * ASYNC_ROUNDS * 1000.0 / elapsed : 0.0, 1);
+
+#ifdef ARDUINO_WIFI_ASYNC_API
+    for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1, state[i].events);
+    }
+#endif
+}
+
+TEST_IFX(wifi_async_client, clients_stop) {
+    for (uint8_t i = 0; i < ASYNC_CLIENTS; i++) {
+        clients[i].stop();
+        TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, clients[i].status());
+    }
+}
+
+TEST_IFX(wifi_async_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_async_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_async_client) {
+    RUN_TEST_CASE(wifi_async_client, idle_calibrate);
+    RUN_TEST_CASE(wifi_async_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_async_client, clients_connect);
+    RUN_TEST_CASE(wifi_async_client, clients_exchange);
+    RUN_TEST_CASE(wifi_async_client, clients_stop);
+    RUN_TEST_CASE(wifi_async_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_async_client, wifi_end);
+}
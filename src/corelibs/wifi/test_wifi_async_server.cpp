@@ -0,0 +1,103 @@
+/**
+ * @brief This test starts a WiFi (TCP) echo server for the many clients of the
+ * "test_wifi_async_client.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Start the access point
+ * - Start the server
+ * - Echo the data of every connected client until all clients disconnected
+ * - Stop the server
+ * - Disconnect the WiFi connection
+ * - End the WiFi
+ *
+ * This test is paired in the "test_wifi_async_client.cpp" test, which needs to be
+ * executed in a second board to operate the clients connecting to this server.
+ *
+ * @note This test must be run before the "test_wifi_async_client.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiServer.h>
+
+#define ASYNC_PORT                  5007
+#define ASYNC_IDLE_TIMEOUT_MS       120000
+
+TEST_GROUP(wifi_async_server);
+
+static TEST_SETUP(wifi_async_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_async_server) {
+}
+
+WiFiServer server;
+
+TEST_IFX(wifi_async_server, wifi_begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_async_server, server_begin) {
+    server.begin(ASYNC_PORT);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_LISTENING, server.status());
+}
+
+TEST_IFX(wifi_async_server, server_echo) {
+    uint8_t buf[64];
+    uint32_t echoed = 0;
+    uint8_t connectedPeak = 0;
+    uint32_t lastActivity = millis();
+
+    /* Serve until the clients have connected and all of them are gone again */
+    while (connectedPeak == 0 || server.connectedSize() > 0) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastActivity) < ASYNC_IDLE_TIMEOUT_MS, "No client activity");
+
+        if (server.connectedSize() > connectedPeak) {
+            connectedPeak = server.connectedSize();
+        }
+
+        /* The available returns a client which is connected
+        and has available data */
+        WiFiClient client = server.available();
+        if (!client) {
+            continue;
+        }
+        lastActivity = millis();
+
+        int read_bytes = client.read(buf, sizeof(buf));
+        if (read_bytes > 0 && client.write(buf, read_bytes) == (size_t)read_bytes) {
+            echoed += read_bytes;
+        }
+    }
+
+    Serial.print("\nClients peak: ");
+    Serial.print(connectedPeak);
+    Serial.print(", echoed bytes: ");
+    Serial.println(echoed);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, echoed);
+}
+
+TEST_IFX(wifi_async_server, server_end) {
+    server.end();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, server.status());
+}
+
+TEST_IFX(wifi_async_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_async_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_UINT8(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_async_server) {
+    RUN_TEST_CASE(wifi_async_server, wifi_begin_ap);
+    RUN_TEST_CASE(wifi_async_server, server_begin);
+    RUN_TEST_CASE(wifi_async_server, server_echo);
+    RUN_TEST_CASE(wifi_async_server, server_end);
+    RUN_TEST_CASE(wifi_async_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_async_server, wifi_end);
+}
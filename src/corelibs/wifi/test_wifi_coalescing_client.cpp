@@ -0,0 +1,302 @@
+/**
+ * @brief This test creates a WiFi (TCP) client which issues chatty small writes and
+ * measures the latency and throughput trade-off of their coalescing into segments.
+ *
+ * @details Every message has COALESCE_MSG_SIZE bytes and is written with one of the
+ * write patterns of the basic client test:
+ * - write(buf, 64): the whole message at once (reference)
+ * - write(c) + write(buf, 63): as client_write of test_wifi_client.cpp
+ * - print() + println(): as client_print of test_wifi_client.cpp
+ * - 64 x write(c): one call per byte
+ *
+ * The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_coalescing_server.cpp test
+ * - Connect to the server
+ * - For every no-delay mode and write pattern:
+ *   - latency phase: send COALESCE_LATENCY_MESSAGES messages, each waiting for the
+ *     acknowledge of the server, and record the round trip time per message
+ *   - stream phase: send COALESCE_STREAM_MESSAGES messages back to back and measure
+ *     the throughput until the server acknowledged all of them
+ * - Report latency and throughput per write pattern and mode. The server reports
+ *   the receive chunks (segments) per message.
+ * - Stop the client, disconnect the wifi connection and end the WiFi
+ *
+ * With a core defining ARDUINO_WIFICLIENT_NODELAY, the series are run with the
+ * coalescing of small writes enabled and disabled, using the proposed switch:
+ *
+ *   void WiFiClient::setNoDelay(bool nodelay);
+ *   bool WiFiClient::getNoDelay();
+ *
+ * - setNoDelay(true) sends every write immediately in a segment of its own
+ *   (TCP_NODELAY). setNoDelay(false) lets the stack hold back small segments while
+ *   data is unacknowledged (Nagle's algorithm).
+ *
+ * Without it, the series run once with the default behaviour of the core.
+ *
+ * This test is paired in the "test_wifi_coalescing_server.cpp" test, which needs to be
+ * executed in a second board to provide the server observing the segments.
+ *
+ * @note This test must be run after the "test_wifi_coalescing_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#define COALESCE_PORT               5008
+#define COALESCE_MSG_SIZE           64
+#define COALESCE_HEADER_SIZE        6 // command, pattern, mode, phase, message count (2 bytes)
+#define COALESCE_LATENCY_MESSAGES   50
+#define COALESCE_STREAM_MESSAGES    500
+#define COALESCE_TIMEOUT_MS         60000
+
+typedef enum {
+    PATTERN_SINGLE = 0,
+    PATTERN_FIRST_BYTE,
+    PATTERN_PRINT,
+    PATTERN_BYTEWISE,
+    PATTERNS
+} coalesce_pattern_t;
+
+typedef enum {
+    MODE_DEFAULT = 0,
+    MODE_COALESCING,
+    MODE_NODELAY,
+    MODES
+} coalesce_mode_t;
+
+typedef enum {
+    PHASE_LATENCY = 0,
+    PHASE_STREAM,
+    PHASES
+} coalesce_phase_t;
+
+static const char *patternNames[PATTERNS] = {"write(buf, 64)", "write(c) + write(buf, 63)",
+                                             "print() + println()", "64 x write(c)"};
+static const char *modeNames[MODES] = {"default", "coalescing", "no-delay"};
+
+#ifdef ARDUINO_WIFICLIENT_NODELAY
+static const uint8_t testedModes[] = {MODE_COALESCING, MODE_NODELAY};
+#else
+static const uint8_t testedModes[] = {MODE_DEFAULT};
+#endif
+#define COALESCE_TESTED_MODES       (sizeof(testedModes) / sizeof(testedModes[0]))
+
+TEST_GROUP(wifi_coalescing_client);
+
+static TEST_SETUP(wifi_coalescing_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_coalescing_client) {
+}
+
+WiFiClient client;
+
+static RunningStats latencyUs[COALESCE_TESTED_MODES][PATTERNS];
+static double streamKBps[COALESCE_TESTED_MODES][PATTERNS];
+
+/* Message content shared with the server: printable
+characters, terminated by the println() line ending */
+static inline uint8_t messageByte(uint16_t message, uint8_t offset) {
+    if (offset >= COALESCE_MSG_SIZE - 2) {
+        return offset == COALESCE_MSG_SIZE - 2 ? '\r' : '\n';
+    }
+    return (uint8_t)('a' + (message + offset) % 26);
+}
+
+static bool readExactly(uint8_t *buf, size_t len) {
+    size_t received = 0;
+    uint32_t start = millis();
+
+    while (received < len) {
+        int avail = client.available();
+        if (avail > 0) {
+            size_t request = len - received;
+            if ((size_t)avail < request) {
+                request = avail;
+            }
+            int read_bytes = client.read(buf + received, request);
+            if (read_bytes > 0) {
+                received += read_bytes;
+            }
+        } else if (!client.connected() || (millis() - start) > COALESCE_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write one message with the given write pattern.
+ */
+static void writeMessage(uint8_t pattern, uint16_t message) {
+    char text[COALESCE_MSG_SIZE + 1];
+    size_t written = 0;
+
+    for (uint8_t i = 0; i < COALESCE_MSG_SIZE; i++) {
+        text[i] = (char)messageByte(message, i);
+    }
+    text[COALESCE_MSG_SIZE] = '\0';
+
+    switch (pattern) {
+    case PATTERN_SINGLE:
+        written = client.write((const uint8_t *)text, COALESCE_MSG_SIZE);
+        break;
+    case PATTERN_FIRST_BYTE:
+        written = client.write((uint8_t)text[0]);
+        written += client.write((const uint8_t *)&text[1], COALESCE_MSG_SIZE - 1);
+        break;
+    case PATTERN_PRINT: {
+        /* A 3 bytes prompt, then the rest of the line */
+        char prompt[4] = {text[0], text[1], text[2], '\0'};
+        text[COALESCE_MSG_SIZE - 2] = '\0';
+        written = client.print(prompt);
+        written += client.println(&text[3]);
+        break;
+    }
+    default:
+        for (uint8_t i = 0; i < COALESCE_MSG_SIZE; i++) {
+            written += client.write((uint8_t)text[i]);
+        }
+        break;
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(COALESCE_MSG_SIZE, written, "Message not written");
+}
+
+static void startSeries(uint8_t pattern, uint8_t mode, uint8_t phase, uint16_t messages) {
+    uint8_t header[COALESCE_HEADER_SIZE] = {
+        'S', pattern, mode, phase, (uint8_t)(messages & 0xFF), (uint8_t)(messages >> 8)
+    };
+    uint8_t ack = 0;
+
+#ifdef ARDUINO_WIFICLIENT_NODELAY
+    if (mode != MODE_DEFAULT) {
+        client.setNoDelay(mode == MODE_NODELAY);
+        TEST_ASSERT_EQUAL(mode == MODE_NODELAY, client.getNoDelay());
+    }
+#endif
+    TEST_ASSERT_EQUAL_INT(COALESCE_HEADER_SIZE, client.write(header, sizeof(header)));
+    TEST_ASSERT_TRUE_MESSAGE(readExactly(&ack, 1), "No series acknowledge");
+    TEST_ASSERT_EQUAL_CHAR('A', ack);
+}
+
+static void runLatency(uint8_t modeIndex, uint8_t pattern) {
+    startSeries(pattern, testedModes[modeIndex], PHASE_LATENCY, COALESCE_LATENCY_MESSAGES);
+
+    for (uint16_t m = 0; m < COALESCE_LATENCY_MESSAGES; m++) {
+        uint8_t ack = 0;
+        uint32_t start = micros();
+        writeMessage(pattern, m);
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(&ack, 1), "No message acknowledge");
+        latencyUs[modeIndex][pattern].add(micros() - start);
+        TEST_ASSERT_EQUAL_CHAR('K', ack);
+    }
+}
+
+static void runStream(uint8_t modeIndex, uint8_t pattern) {
+    uint8_t acks[64];
+    uint16_t acked = 0;
+
+    startSeries(pattern, testedModes[modeIndex], PHASE_STREAM, COALESCE_STREAM_MESSAGES);
+
+    uint32_t start = micros();
+    for (uint16_t m = 0; m < COALESCE_STREAM_MESSAGES; m++) {
+        writeMessage(pattern, m);
+
+        /* Drain the acknowledges meanwhile, without waiting for them */
+        int avail = client.available();
+        if (avail > 0) {
+            int read_bytes = client.read(acks, (size_t)avail < sizeof(acks) ? (size_t)avail : sizeof(acks));
+            if (read_bytes > 0) {
+                acked += read_bytes;
+            }
+        }
+    }
+    while (acked < COALESCE_STREAM_MESSAGES) {
+        size_t remaining = COALESCE_STREAM_MESSAGES - acked;
+        size_t len = remaining < sizeof(acks) ? remaining : sizeof(acks);
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(acks, len), "Stream not acknowledged");
+        acked += len;
+    }
+    uint32_t elapsed = micros() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    streamKBps[modeIndex][pattern] = (double)COALESCE_STREAM_MESSAGES * COALESCE_MSG_SIZE * 1000.0 / elapsed;
+}
+
+TEST_IFX(wifi_coalescing_client, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_coalescing_client, client_connect) {
+    IPAddress ip(192, 168, 0, 1);
+    TEST_ASSERT_TRUE(client.connect(ip, COALESCE_PORT));
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_CONNECTED, client.status());
+}
+
+TEST_IFX(wifi_coalescing_client, client_latency_series) {
+    for (uint8_t mode = 0; mode < COALESCE_TESTED_MODES; mode++) {
+        for (uint8_t pattern = 0; pattern < PATTERNS; pattern++) {
+            runLatency(mode, pattern);
+        }
+    }
+}
+
+TEST_IFX(wifi_coalescing_client, client_stream_series) {
+    for (uint8_t mode = 0; mode < COALESCE_TESTED_MODES; mode++) {
+        for (uint8_t pattern = 0; pattern < PATTERNS; pattern++) {
+            runStream(mode, pattern);
+        }
+    }
+}
+
+TEST_IFX(wifi_coalescing_client, client_report_tradeoff) {
+#ifndef ARDUINO_WIFICLIENT_NODELAY
+    Serial.println("\nNo-delay switch not supported by the core, default mode only");
+#endif
+    for (uint8_t mode = 0; mode < COALESCE_TESTED_MODES; mode++) {
+        Serial.print("\nMode: ");
+        Serial.println(modeNames[testedModes[mode]]);
+        for (uint8_t pattern = 0; pattern < PATTERNS; pattern++) {
+            latencyUs[mode][pattern].print(patternNames[pattern], "us round trip");
+            Serial.print("  stream: ");
+            Serial.print(streamKBps[mode][pattern], 1);
+            Serial.println(" kB/s");
+
+            TEST_ASSERT_EQUAL_UINT32(COALESCE_LATENCY_MESSAGES, latencyUs[mode][pattern].count());
+            TEST_ASSERT_TRUE(streamKBps[mode][pattern] > 0);
+        }
+    }
+}
+
+TEST_IFX(wifi_coalescing_client, client_stop) {
+    uint8_t quit[COALESCE_HEADER_SIZE] = {'Q', 0, 0, 0, 0, 0};
+    TEST_ASSERT_EQUAL_INT(COALESCE_HEADER_SIZE, client.write(quit, sizeof(quit)));
+    client.stop();
+    TEST_ASSERT_FALSE(client.connected());
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, client.status());
+}
+
+TEST_IFX(wifi_coalescing_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_coalescing_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_coalescing_client) {
+    RUN_TEST_CASE(wifi_coalescing_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_coalescing_client, client_connect);
+    RUN_TEST_CASE(wifi_coalescing_client, client_latency_series);
+    RUN_TEST_CASE(wifi_coalescing_client, client_stream_series);
+    RUN_TEST_CASE(wifi_coalescing_client, client_report_tradeoff);
+    RUN_TEST_CASE(wifi_coalescing_client, client_stop);
+    RUN_TEST_CASE(wifi_coalescing_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_coalescing_client, wifi_end);
+}
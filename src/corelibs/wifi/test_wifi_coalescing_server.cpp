@@ -0,0 +1,226 @@
+/**
+ * @brief This test starts a WiFi (TCP) server which observes how the small writes
+ * of the "test_wifi_coalescing_client.cpp" test are coalesced into segments.
+ *
+ * @details The tests runs the following sequence:
+ * - Start the access point
+ * - Start the server
+ * - Wait for the client to connect
+ * - Serve the series of the client until it quits. Every series starts with a
+ *   COALESCE_HEADER_SIZE bytes header (command 'S', write pattern, no-delay mode,
+ *   phase, message count), acknowledged with 'A'. Then every message of
+ *   COALESCE_MSG_SIZE bytes is verified and acknowledged with 'K'.
+ * - Report the receive chunks per message of every series
+ * - Stop the server
+ * - Disconnect the WiFi connection
+ * - End the WiFi
+ *
+ * The server polls available() in a tight loop and reads all the available data at
+ * once. Every read is a receive chunk: a segment arriving between two polls is a chunk
+ * of its own, so the chunks per message are the segments per message the write
+ * pattern produced. Segments arriving faster than the loop polls are merged, the
+ * count is therefore a lower bound.
+ *
+ * This test is paired in the "test_wifi_coalescing_client.cpp" test, which needs to be
+ * executed in a second board to operate the client issuing the small writes.
+ *
+ * @note This test must be run before the "test_wifi_coalescing_client.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiServer.h>
+
+#define COALESCE_PORT               5008
+#define COALESCE_MSG_SIZE           64
+#define COALESCE_HEADER_SIZE        6 // command, pattern, mode, phase, message count (2 bytes)
+#define COALESCE_MAX_SERIES         32
+#define COALESCE_TIMEOUT_MS         60000
+
+typedef enum {
+    PATTERN_SINGLE = 0,
+    PATTERN_FIRST_BYTE,
+    PATTERN_PRINT,
+    PATTERN_BYTEWISE,
+    PATTERNS
+} coalesce_pattern_t;
+
+static const char *patternNames[PATTERNS] = {"write(buf, 64)", "write(c) + write(buf, 63)",
+                                             "print() + println()", "64 x write(c)"};
+static const char *modeNames[] = {"default", "coalescing", "no-delay"};
+static const char *phaseNames[] = {"latency", "stream"};
+
+typedef struct {
+    uint8_t pattern;
+    uint8_t mode;
+    uint8_t phase;
+    uint16_t messages;
+    uint32_t chunks;
+    uint32_t errors;
+} coalesce_series_t;
+
+TEST_GROUP(wifi_coalescing_server);
+
+static TEST_SETUP(wifi_coalescing_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_coalescing_server) {
+}
+
+WiFiServer server;
+WiFiClient client;
+
+static coalesce_series_t series[COALESCE_MAX_SERIES];
+static uint8_t seriesCount = 0;
+
+/* Message content shared with the client: printable
+characters, terminated by the println() line ending */
+static inline uint8_t messageByte(uint16_t message, uint8_t offset) {
+    if (offset >= COALESCE_MSG_SIZE - 2) {
+        return offset == COALESCE_MSG_SIZE - 2 ? '\r' : '\n';
+    }
+    return (uint8_t)('a' + (message + offset) % 26);
+}
+
+static bool readExactly(uint8_t *buf, size_t len) {
+    size_t received = 0;
+    uint32_t start = millis();
+
+    while (received < len) {
+        int avail = client.available();
+        if (avail > 0) {
+            size_t request = len - received;
+            if ((size_t)avail < request) {
+                request = avail;
+            }
+            int read_bytes = client.read(buf + received, request);
+            if (read_bytes > 0) {
+                received += read_bytes;
+            }
+        } else if (!client.connected() || (millis() - start) > COALESCE_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Receive the messages of a series, counting the receive chunks.
+ */
+static void receiveSeries(coalesce_series_t &s, uint16_t expected) {
+    uint8_t buf[256];
+    uint8_t offset = 0;
+    uint32_t start = millis();
+
+    while (s.messages < expected) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < COALESCE_TIMEOUT_MS, "Series incomplete");
+
+        int avail = client.available();
+        if (avail <= 0) {
+            continue;
+        }
+        int read_bytes = client.read(buf, (size_t)avail < sizeof(buf) ? (size_t)avail : sizeof(buf));
+        if (read_bytes <= 0) {
+            continue;
+        }
+        s.chunks++;
+
+        for (int i = 0; i < read_bytes; i++) {
+            if (buf[i] != messageByte(s.messages, offset)) {
+                s.errors++;
+            }
+            if (++offset == COALESCE_MSG_SIZE) {
+                offset = 0;
+                s.messages++;
+                client.write('K');
+            }
+        }
+    }
+}
+
+TEST_IFX(wifi_coalescing_server, wifi_begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_coalescing_server, server_begin) {
+    server.begin(COALESCE_PORT);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_LISTENING, server.status());
+}
+
+TEST_IFX(wifi_coalescing_server, server_accept_client) {
+    uint32_t start = millis();
+    do {
+        client = server.available();
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < COALESCE_TIMEOUT_MS, "No client connected");
+    } while (!client);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_CONNECTED, client.status());
+}
+
+TEST_IFX(wifi_coalescing_server, server_serve_series) {
+    uint8_t header[COALESCE_HEADER_SIZE];
+
+    while (true) {
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(header, sizeof(header)), "Series header incomplete");
+        if (header[0] == 'Q') {
+            break;
+        }
+        TEST_ASSERT_EQUAL_CHAR('S', header[0]);
+        TEST_ASSERT_LESS_THAN_UINT8(COALESCE_MAX_SERIES, seriesCount);
+
+        coalesce_series_t &s = series[seriesCount++];
+        s.pattern = header[1];
+        s.mode = header[2];
+        s.phase = header[3];
+        TEST_ASSERT_LESS_THAN_UINT8(PATTERNS, s.pattern);
+
+        /* The acknowledge separates the header from the first message */
+        TEST_ASSERT_EQUAL_INT(1, client.write('A'));
+        receiveSeries(s, (uint16_t)(header[4] | (header[5] << 8)));
+    }
+    TEST_ASSERT_GREATER_THAN_UINT8(0, seriesCount);
+}
+
+TEST_IFX(wifi_coalescing_server, server_report_chunks) {
+    Serial.println("\nReceive chunks per message of COALESCE_MSG_SIZE bytes");
+    Serial.println("pattern\t\t\t\tmode\t\tphase\t\tchunks/message");
+    for (uint8_t i = 0; i < seriesCount; i++) {
+        const coalesce_series_t &s = series[i];
+        Serial.print(patternNames[s.pattern]);
+        Serial.print("\t\t");
+        Serial.print(modeNames[s.mode]);
+        Serial.print("\t");
+        Serial.print(phaseNames[s.phase]);
+        Serial.print("\t\t");
+        Serial.println(s.messages > 0 ? (double)s.chunks / s.messages : 0.0, 2);
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, s.errors, "Message content corrupted");
+    }
+}
+
+TEST_IFX(wifi_coalescing_server, server_end) {
+    client.stop();
+    server.end();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, server.status());
+}
+
+TEST_IFX(wifi_coalescing_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_coalescing_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_UINT8(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_coalescing_server) {
+    RUN_TEST_CASE(wifi_coalescing_server, wifi_begin_ap);
+    RUN_TEST_CASE(wifi_coalescing_server, server_begin);
+    RUN_TEST_CASE(wifi_coalescing_server, server_accept_client);
+    RUN_TEST_CASE(wifi_coalescing_server, server_serve_series);
+    RUN_TEST_CASE(wifi_coalescing_server, server_report_chunks);
+    RUN_TEST_CASE(wifi_coalescing_server, server_end);
+    RUN_TEST_CASE(wifi_coalescing_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_coalescing_server, wifi_end);
+}
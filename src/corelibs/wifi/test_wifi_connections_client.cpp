@@ -0,0 +1,166 @@
+/**
+ * @brief This test creates as many concurrent WiFi (TCP) clients as the stack
+ * allows and connects them to the server of the "test_wifi_connections_server.cpp"
+ * test.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_connections_server.cpp test
+ * - Repeat CONNECTIONS_CYCLES times:
+ *   - Open client connections until connect() fails or CONNECTIONS_MAX is reached,
+ *     each client announcing itself to the server with one byte
+ *   - Stop all clients
+ * - Report the concurrency limit, the connection rate per wall clock second of the
+ *   opening phase of every cycle, the connect() latency and the heap used per connection
+ * - Check every cycle reached the same number of connections and the heap
+ *   returned to the level of the first cycle, i.e. no sockets or memory leak
+ * - Send the quit request to the server
+ * - Disconnect the wifi connection and end the WiFi
+ *
+ * CONNECTIONS_MAX can be overridden in the test_config.h of the board.
+ *
+ * This test is paired in the "test_wifi_connections_server.cpp" test, which needs to be
+ * executed in a second board to provide the server to which the clients connect to.
+ *
+ * @note This test must be run after the "test_wifi_connections_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#ifndef CONNECTIONS_MAX
+#define CONNECTIONS_MAX                 32
+#endif
+#define CONNECTIONS_PORT                5002
+#define CONNECTIONS_CYCLES              5
+#define CONNECTIONS_SETTLE_MS           500   // time for the stack to release stopped sockets
+#define CONNECTIONS_LEAK_TOLERANCE      256   // bytes
+
+TEST_GROUP(wifi_connections_client);
+
+static TEST_SETUP(wifi_connections_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_connections_client) {
+}
+
+static WiFiClient clients[CONNECTIONS_MAX];
+
+static uint8_t opened[CONNECTIONS_CYCLES];
+static size_t heapPerConnection[CONNECTIONS_CYCLES];
+static size_t heapAfterCycle[CONNECTIONS_CYCLES];
+static double connectRate[CONNECTIONS_CYCLES];
+static RunningStats connectLatency;
+
+TEST_IFX(wifi_connections_client, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_connections_client, client_connection_cycles) {
+    IPAddress ip(192, 168, 0, 1);
+
+    for (uint8_t cycle = 0; cycle < CONNECTIONS_CYCLES; cycle++) {
+        size_t heapBefore = heapUsedBytes();
+        uint8_t count = 0;
+        uint32_t cycleStart = micros();
+        uint32_t lastOpenedUs = 0; // excludes the final connect() that failed
+
+        while (count < CONNECTIONS_MAX) {
+            uint32_t start = micros();
+            bool connected = clients[count].connect(ip, CONNECTIONS_PORT);
+            uint32_t elapsed = micros() - start;
+            if (!connected) {
+                break;
+            }
+
+            connectLatency.add(elapsed);
+
+            TEST_ASSERT_EQUAL_INT(1, clients[count].write('C'));
+            count++;
+            lastOpenedUs = micros() - cycleStart;
+        }
+        connectRate[cycle] = lastOpenedUs > 0 ? (double)count * MICROSECONDS_PER_SECOND / lastOpenedUs : 0.0;
+
+        size_t heapPeak = heapUsedBytes();
+        opened[cycle] = count;
+        heapPerConnection[cycle] = (count > 0 && heapPeak > heapBefore) ? (heapPeak - heapBefore) / count : 0;
+
+        for (uint8_t i = 0; i < count; i++) {
+            clients[i].stop();
+            TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, clients[i].status());
+        }
+        delay(CONNECTIONS_SETTLE_MS);
+        heapAfterCycle[cycle] = heapUsedBytes();
+
+        Serial.print("\nCycle ");
+        Serial.print(cycle);
+        Serial.print(": ");
+        Serial.print(count);
+        Serial.print(" connections, ");
+        Serial.print((unsigned long)heapPerConnection[cycle]);
+        Serial.print(" bytes heap per connection, ");
+        Serial.print(connectRate[cycle], 1);
+        Serial.println(" connections/s");
+    }
+}
+
+TEST_IFX(wifi_connections_client, client_report_scaling) {
+    Serial.print("\nConcurrent connections limit: ");
+    Serial.print(opened[0]);
+    if (opened[0] == CONNECTIONS_MAX) {
+        Serial.print(" (CONNECTIONS_MAX reached, connect() did not fail)");
+    }
+    Serial.println();
+    RunningStats rate;
+    for (uint8_t cycle = 0; cycle < CONNECTIONS_CYCLES; cycle++) {
+        rate.add(connectRate[cycle]);
+    }
+    rate.print("Connection rate per cycle", "connections/s");
+    connectLatency.print("connect() latency", "us");
+
+    /* The existing server tests rely on at least 2 concurrent clients */
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT8(2, opened[0]);
+}
+
+TEST_IFX(wifi_connections_client, client_check_leaks) {
+    for (uint8_t cycle = 1; cycle < CONNECTIONS_CYCLES; cycle++) {
+        /* A leaked socket lowers the number of
+        connections of the following cycles */
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(opened[0], opened[cycle], "Connections limit changed between cycles");
+        TEST_ASSERT_LESS_OR_EQUAL_INT32_MESSAGE(CONNECTIONS_LEAK_TOLERANCE,
+                                                (long)heapAfterCycle[cycle] - (long)heapAfterCycle[0],
+                                                "Heap grows with every cycle");
+    }
+}
+
+TEST_IFX(wifi_connections_client, client_quit) {
+    IPAddress ip(192, 168, 0, 1);
+    WiFiClient client;
+
+    TEST_ASSERT_TRUE(client.connect(ip, CONNECTIONS_PORT));
+    TEST_ASSERT_EQUAL_INT(1, client.write('Q'));
+    client.stop();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, client.status());
+}
+
+TEST_IFX(wifi_connections_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_connections_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_connections_client) {
+    RUN_TEST_CASE(wifi_connections_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_connections_client, client_connection_cycles);
+    RUN_TEST_CASE(wifi_connections_client, client_report_scaling);
+    RUN_TEST_CASE(wifi_connections_client, client_check_leaks);
+    RUN_TEST_CASE(wifi_connections_client, client_quit);
+    RUN_TEST_CASE(wifi_connections_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_connections_client, wifi_end);
+}
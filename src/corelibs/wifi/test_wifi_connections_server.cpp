@@ -0,0 +1,168 @@
+/**
+ * @brief This test starts a WiFi (TCP) server which accepts as many concurrent
+ * clients as the "test_wifi_connections_client.cpp" test opens.
+ *
+ * @details The tests runs the following sequence:
+ * - Start the access point
+ * - Start the server
+ * - Accept client connections until the client sends the quit request:
+ *   every client announces itself with one byte after connecting
+ * - Report the number of accepted connections, the peak of concurrently
+ *   connected clients, the accept rate of every burst and the heap used per
+ *   connection at the peak
+ * - Wait for all clients to disconnect and check the heap is back to the
+ *   level before the first connection
+ * - Stop the server
+ * - Disconnect the WiFi connection
+ * - End the WiFi
+ *
+ * This test is paired in the "test_wifi_connections_client.cpp" test, which needs to be
+ * executed in a second board to operate the clients connecting to this server.
+ *
+ * @note This test must be run before the "test_wifi_connections_client.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiServer.h>
+
+#define CONNECTIONS_PORT                5002
+#define CONNECTIONS_TIMEOUT_MS          120000
+#define CONNECTIONS_BURST_GAP_MS        200   // accept gap starting a new burst
+#define CONNECTIONS_LEAK_TOLERANCE      256   // bytes
+
+TEST_GROUP(wifi_connections_server);
+
+static TEST_SETUP(wifi_connections_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_connections_server) {
+}
+
+WiFiServer server;
+
+static size_t heapBaseline = 0;
+static size_t heapPeak = 0;
+static uint8_t connectedPeak = 0;
+static uint32_t accepted = 0;
+
+TEST_IFX(wifi_connections_server, wifi_begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_connections_server, server_begin) {
+    server.begin(CONNECTIONS_PORT);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_LISTENING, server.status());
+    heapBaseline = heapUsedBytes();
+}
+
+/**
+ * @brief Add the accept rate of the current burst of connections to the statistics.
+ */
+static void closeBurst(RunningStats &burstRate, uint32_t &burstAccepted, uint32_t burstStartUs, uint32_t lastAcceptUs) {
+    if (burstAccepted > 1 && lastAcceptUs != burstStartUs) {
+        burstRate.add((double)(burstAccepted - 1) * MICROSECONDS_PER_SECOND / (double)(lastAcceptUs - burstStartUs));
+    }
+    burstAccepted = 0;
+}
+
+TEST_IFX(wifi_connections_server, server_accept_connections) {
+    RunningStats burstRate;
+    uint32_t burstAccepted = 0;
+    uint32_t burstStartUs = 0;
+    uint32_t lastAcceptUs = micros();
+    uint32_t lastAccept = millis();
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastAccept) < CONNECTIONS_TIMEOUT_MS, "No client connected");
+
+        /* Every client sends one byte after connecting,
+        which makes it available exactly once */
+        WiFiClient client = server.available();
+        if (!client) {
+            continue;
+        }
+
+        uint32_t nowUs = micros();
+        lastAccept = millis();
+        if ((nowUs - lastAcceptUs) > (uint32_t)CONNECTIONS_BURST_GAP_MS * 1000UL) {
+            closeBurst(burstRate, burstAccepted, burstStartUs, lastAcceptUs);
+        }
+
+        if (client.read() == 'Q') {
+            quit = true;
+            continue;
+        }
+
+        if (burstAccepted == 0) {
+            burstStartUs = nowUs;
+        }
+        lastAcceptUs = nowUs;
+        burstAccepted++;
+        accepted++;
+
+        uint8_t connected = server.connectedSize();
+        if (connected > connectedPeak) {
+            connectedPeak = connected;
+            heapPeak = heapUsedBytes();
+        }
+    }
+    closeBurst(burstRate, burstAccepted, burstStartUs, lastAcceptUs);
+
+    Serial.print("\nAccepted connections: ");
+    Serial.println(accepted);
+    Serial.print("Concurrent connections peak: ");
+    Serial.println(connectedPeak);
+    burstRate.print("Accept rate per burst", "connections/s");
+    if (connectedPeak > 0 && heapPeak > heapBaseline) {
+        Serial.print("Heap per connection: ");
+        Serial.print((unsigned long)((heapPeak - heapBaseline) / connectedPeak));
+        Serial.println(" bytes");
+    }
+
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT8(2, connectedPeak);
+}
+
+TEST_IFX(wifi_connections_server, server_check_leaks) {
+    uint32_t start = millis();
+
+    /* Wait until all clients are disconnected
+    from the other side */
+    while(server.connectedSize() > 0) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < CONNECTIONS_TIMEOUT_MS, "Clients not disconnected");
+    }
+
+    size_t heapEnd = heapUsedBytes();
+    Serial.print("\nHeap after all disconnections: ");
+    Serial.print((long)heapEnd - (long)heapBaseline);
+    Serial.println(" bytes above baseline");
+
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(CONNECTIONS_LEAK_TOLERANCE, (long)heapEnd - (long)heapBaseline);
+}
+
+TEST_IFX(wifi_connections_server, server_end) {
+    server.end();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, server.status());
+}
+
+TEST_IFX(wifi_connections_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_connections_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_UINT8(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_connections_server) {
+    RUN_TEST_CASE(wifi_connections_server, wifi_begin_ap);
+    RUN_TEST_CASE(wifi_connections_server, server_begin);
+    RUN_TEST_CASE(wifi_connections_server, server_accept_connections);
+    RUN_TEST_CASE(wifi_connections_server, server_check_leaks);
+    RUN_TEST_CASE(wifi_connections_server, server_end);
+    RUN_TEST_CASE(wifi_connections_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_connections_server, wifi_end);
+}
@@ -0,0 +1,219 @@
+/**
+ * @brief This test benchmarks the WiFi network scan and verifies the cached
+ * and asynchronous scan mode.
+ *
+ * @details The tests runs the following sequence:
+ * - Measure the duration of SCAN_REPEATS blocking scans with WiFi.scanNetworks()
+ * - Measure the cost per call of the per-index accessors SSID(i), RSSI(i),
+ *   encryptionType(i), BSSID(i, bssid) and channel(i), which must read the
+ *   results of the last scan without rescanning
+ * - Start an asynchronous scan, poll its completion from a loop which keeps
+ *   running meanwhile, and read the cached results
+ * - Connect to the access point created by the "test_wifi_ap.cpp" test and
+ *   disconnect again, which lets the access point test complete
+ *
+ * The asynchronous scan is a proposed extension of the WiFi class, available when
+ * the core defines ARDUINO_WIFI_ASYNC_SCAN:
+ *
+ *   int8_t scanNetworks(bool async);
+ *   int8_t scanComplete();
+ *   void scanDelete();
+ *
+ * - scanNetworks(true) starts the scan and returns WIFI_SCAN_RUNNING immediately.
+ * - scanComplete() returns WIFI_SCAN_RUNNING while the scan runs, and the number
+ *   of networks found once it is completed. The results stay cached and are read
+ *   with the per-index accessors until scanDelete() or the next scan.
+ * - After scanDelete() or if no scan was started, scanComplete() returns WIFI_SCAN_FAILED.
+ *
+ * This test is paired with the "test_wifi_ap.cpp" test, which running on a
+ * second board will provide the access point to be found by the scans.
+ *
+ * @note This test must be run after the "test_wifi_ap.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+
+#define SCAN_REPEATS                5
+#define SCAN_ACCESSOR_REPEATS       100
+#define SCAN_ASYNC_START_MAX_MS     50
+#define SCAN_TIMEOUT_MS             30000
+
+TEST_GROUP(wifi_scan);
+
+static TEST_SETUP(wifi_scan) {
+}
+
+static TEST_TEAR_DOWN(wifi_scan) {
+}
+
+static RunningStats scanMs;
+
+static int8_t findAccessPoint(int8_t num_networks) {
+    for (int8_t i = 0; i < num_networks; i++) {
+        if (strcmp(WiFi.SSID(i), "arduino-wifi-ap") == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TEST_IFX(wifi_scan, scan_blocking_duration) {
+    int8_t num_networks = 0;
+
+    for (uint8_t i = 0; i < SCAN_REPEATS; i++) {
+        uint32_t start = micros();
+        num_networks = WiFi.scanNetworks();
+        scanMs.add((micros() - start) / 1000.0);
+
+        TEST_ASSERT_GREATER_THAN_INT8(0, num_networks);
+        TEST_ASSERT_GREATER_OR_EQUAL_INT8(0, findAccessPoint(num_networks));
+    }
+
+    Serial.print("\nNetworks found: ");
+    Serial.println(num_networks);
+    scanMs.print("Blocking scanNetworks()", "ms");
+}
+
+TEST_IFX(wifi_scan, scan_accessor_cost) {
+    RunningStats ssidUs, rssiUs, encryptionUs, bssidUs, channelUs;
+    uint8_t bssid[6];
+
+    int8_t num_networks = WiFi.scanNetworks();
+    TEST_ASSERT_GREATER_THAN_INT8(0, num_networks);
+    int8_t ap_index = findAccessPoint(num_networks);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT8(0, ap_index);
+
+    for (uint16_t repeat = 0; repeat < SCAN_ACCESSOR_REPEATS; repeat++) {
+        for (int8_t i = 0; i < num_networks; i++) {
+            uint32_t start = micros();
+            volatile const char *ssid = WiFi.SSID(i);
+            ssidUs.add(micros() - start);
+            (void)ssid;
+
+            start = micros();
+            volatile int32_t rssi = WiFi.RSSI(i);
+            rssiUs.add(micros() - start);
+            (void)rssi;
+
+            start = micros();
+            volatile uint8_t encryption = WiFi.encryptionType(i);
+            encryptionUs.add(micros() - start);
+            (void)encryption;
+
+            start = micros();
+            WiFi.BSSID(i, bssid);
+            bssidUs.add(micros() - start);
+
+            start = micros();
+            volatile int32_t channel = WiFi.channel(i);
+            channelUs.add(micros() - start);
+            (void)channel;
+        }
+    }
+
+    Serial.println();
+    ssidUs.print("SSID(i)", "us");
+    rssiUs.print("RSSI(i)", "us");
+    encryptionUs.print("encryptionType(i)", "us");
+    bssidUs.print("BSSID(i, bssid)", "us");
+    channelUs.print("channel(i)", "us");
+
+    /* The accessors read the results of the last scan. A single
+    call far below the scan duration proves no rescan happens. */
+    TEST_ASSERT_TRUE(ssidUs.maximum() * 10 < scanMs.minimum() * 1000.0);
+    TEST_ASSERT_TRUE(rssiUs.maximum() * 10 < scanMs.minimum() * 1000.0);
+    TEST_ASSERT_TRUE(bssidUs.maximum() * 10 < scanMs.minimum() * 1000.0);
+    TEST_ASSERT_EQUAL_STRING("arduino-wifi-ap", WiFi.SSID(ap_index));
+}
+
+TEST_IFX(wifi_scan, scan_async_poll) {
+#ifdef ARDUINO_WIFI_ASYNC_SCAN
+    uint32_t loops = 0;
+    uint32_t maxPollUs = 0;
+
+    uint32_t start = millis();
+    TEST_ASSERT_EQUAL_INT8(WIFI_SCAN_RUNNING, WiFi.scanNetworks(true));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SCAN_ASYNC_START_MAX_MS, millis() - start);
+
+    /* The loop keeps running while the scan is in progress,
+    as an application main loop would */
+    int8_t result = WIFI_SCAN_RUNNING;
+    while (result == WIFI_SCAN_RUNNING) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - start) < SCAN_TIMEOUT_MS, "Asynchronous scan not completed");
+
+        uint32_t pollStart = micros();
+        result = WiFi.scanComplete();
+        uint32_t pollUs = micros() - pollStart;
+        if (pollUs > maxPollUs) {
+            maxPollUs = pollUs;
+        }
+        loops++;
+    }
+    uint32_t duration = millis() - start;
+
+    TEST_ASSERT_GREATER_THAN_INT8(0, result);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT8(0, findAccessPoint(result));
+
+    Serial.print("\nAsynchronous scan: ");
+    Serial.print(duration);
+    Serial.print(" ms, ");
+    Serial.print(loops);
+    Serial.print(" loop iterations, longest scanComplete() ");
+    Serial.print(maxPollUs);
+    Serial.println(" us");
+#else
+    TEST_IGNORE_MESSAGE("Asynchronous scan not supported by the core (ARDUINO_WIFI_ASYNC_SCAN)");
+#endif
+}
+
+TEST_IFX(wifi_scan, scan_async_cached_results) {
+#ifdef ARDUINO_WIFI_ASYNC_SCAN
+    /* The results of the previous asynchronous scan are cached */
+    uint32_t start = micros();
+    int8_t num_networks = WiFi.scanComplete();
+    uint32_t elapsed = micros() - start;
+
+    TEST_ASSERT_GREATER_THAN_INT8(0, num_networks);
+    TEST_ASSERT_TRUE(elapsed * 10 < scanMs.minimum() * 1000.0);
+    int8_t ap_index = findAccessPoint(num_networks);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT8(0, ap_index);
+    TEST_ASSERT_EQUAL_INT(AUTH_MODE_WPA2, WiFi.encryptionType(ap_index));
+    TEST_ASSERT_EQUAL_INT(1, WiFi.channel(ap_index));
+
+    /* Reading the results again does not change them */
+    TEST_ASSERT_EQUAL_INT8(num_networks, WiFi.scanComplete());
+
+    WiFi.scanDelete();
+    TEST_ASSERT_EQUAL_INT8(WIFI_SCAN_FAILED, WiFi.scanComplete());
+#else
+    TEST_IGNORE_MESSAGE("Asynchronous scan not supported by the core (ARDUINO_WIFI_ASYNC_SCAN)");
+#endif
+}
+
+TEST_IFX(wifi_scan, connect_to_ap) {
+    /* The access point test waits for a
+    station to connect and to disconnect */
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_scan, disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_scan, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_scan) {
+    RUN_TEST_CASE(wifi_scan, scan_blocking_duration);
+    RUN_TEST_CASE(wifi_scan, scan_accessor_cost);
+    RUN_TEST_CASE(wifi_scan, scan_async_poll);
+    RUN_TEST_CASE(wifi_scan, scan_async_cached_results);
+    RUN_TEST_CASE(wifi_scan, connect_to_ap);
+    RUN_TEST_CASE(wifi_scan, disconnect);
+    RUN_TEST_CASE(wifi_scan, wifi_end);
+}
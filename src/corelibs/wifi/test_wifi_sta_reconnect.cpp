@@ -0,0 +1,196 @@
+/**
+ * @brief This test profiles the connect and reconnect latency of a WiFi station
+ * over repeated begin() -> connected -> disconnect() cycles.
+ *
+ * @details Every cycle is split in the following phases:
+ * - association: duration of the WiFi.begin() call until WL_CONNECTED
+ * - ip: from the return of begin() until a local IP address is assigned
+ *   (0 for cores whose begin() only returns once the address is assigned)
+ * - first packet: from the assigned address until the first UDP echo of the
+ *   access point is received, i.e. the time until the link carries data
+ * - disconnect: duration of the WiFi.disconnect() call
+ *
+ * The cycles are run twice: first with DHCP, then with a static IP configuration.
+ * The difference of the connect times of both series is the cost of DHCP.
+ * The distribution (mean, std, min, max) of every phase is reported per series.
+ *
+ * RECONNECT_CYCLES can be overridden in the test_config.h of the board.
+ *
+ * This test is paired with the "test_wifi_ap_reconnect.cpp" test, which
+ * running on a second board will provide the access point and the UDP echo.
+ *
+ * @note This test must be run after the "test_wifi_ap_reconnect.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef RECONNECT_CYCLES
+#define RECONNECT_CYCLES            20
+#endif
+#define RECONNECT_ECHO_PORT         5006
+#define RECONNECT_TIMEOUT_MS        10000
+#define RECONNECT_PROBE_INTERVAL_MS 10
+
+typedef enum {
+    PHASE_ASSOCIATION = 0,
+    PHASE_IP,
+    PHASE_FIRST_PACKET,
+    PHASE_DISCONNECT,
+    PHASES
+} reconnect_phase_t;
+
+static const char *phaseNames[PHASES] = {"association", "ip", "first packet", "disconnect"};
+
+TEST_GROUP(wifi_sta_reconnect);
+
+static TEST_SETUP(wifi_sta_reconnect) {
+}
+
+static TEST_TEAR_DOWN(wifi_sta_reconnect) {
+}
+
+WiFiUDP udpProbe;
+
+static RunningStats dhcpPhaseMs[PHASES];
+static RunningStats staticPhaseMs[PHASES];
+static RunningStats dhcpConnectMs;
+static RunningStats staticConnectMs;
+
+static bool hasLocalIP() {
+    IPAddress ip = WiFi.localIP();
+    return ip[0] != 0 || ip[1] != 0 || ip[2] != 0 || ip[3] != 0;
+}
+
+/**
+ * @brief Send probe datagrams to the access point until the first echo is received.
+ */
+static bool waitFirstPacket() {
+    IPAddress apIP(192, 168, 0, 1);
+    uint32_t start = millis();
+    uint8_t seq = 0;
+
+    while ((millis() - start) < RECONNECT_TIMEOUT_MS) {
+        uint8_t probe[2] = {'P', seq++};
+        if (udpProbe.beginPacket(apIP, RECONNECT_ECHO_PORT)) {
+            udpProbe.write(probe, sizeof(probe));
+            udpProbe.endPacket();
+        }
+
+        uint32_t sent = millis();
+        while ((millis() - sent) < RECONNECT_PROBE_INTERVAL_MS) {
+            if (udpProbe.parsePacket() > 0) {
+                udpProbe.flush();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Run one connect -> first packet -> disconnect cycle and record its phases.
+ */
+static void reconnectCycle(RunningStats *phaseMs, RunningStats &connectMs) {
+    uint32_t times[PHASES];
+
+    uint32_t start = micros();
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    times[PHASE_ASSOCIATION] = micros() - start;
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+
+    start = micros();
+    uint32_t timeout = millis();
+    while (!hasLocalIP()) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - timeout) < RECONNECT_TIMEOUT_MS, "No IP address assigned");
+    }
+    times[PHASE_IP] = micros() - start;
+
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpProbe.begin(RECONNECT_ECHO_PORT));
+    start = micros();
+    TEST_ASSERT_TRUE_MESSAGE(waitFirstPacket(), "No echo from the access point");
+    times[PHASE_FIRST_PACKET] = micros() - start;
+    udpProbe.stop();
+
+    start = micros();
+    WiFi.disconnect();
+    times[PHASE_DISCONNECT] = micros() - start;
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+
+    for (uint8_t i = 0; i < PHASES; i++) {
+        phaseMs[i].add(times[i] / 1000.0);
+    }
+    connectMs.add((times[PHASE_ASSOCIATION] + times[PHASE_IP] + times[PHASE_FIRST_PACKET]) / 1000.0);
+}
+
+static void printPhases(const char *title, const RunningStats *phaseMs, const RunningStats &connectMs) {
+    Serial.print("\n");
+    Serial.println(title);
+    for (uint8_t i = 0; i < PHASES; i++) {
+        phaseMs[i].print(phaseNames[i], "ms");
+    }
+    connectMs.print("connect total", "ms");
+}
+
+TEST_IFX(wifi_sta_reconnect, reconnect_cycles_dhcp) {
+    for (uint16_t cycle = 0; cycle < RECONNECT_CYCLES; cycle++) {
+        reconnectCycle(dhcpPhaseMs, dhcpConnectMs);
+    }
+    TEST_ASSERT_EQUAL_UINT32(RECONNECT_CYCLES, dhcpConnectMs.count());
+}
+
+TEST_IFX(wifi_sta_reconnect, reconnect_cycles_static_ip) {
+    IPAddress local_ip(192, 168, 0, 10);
+    IPAddress dns_server(192, 168, 0, 1);
+    IPAddress gateway(192, 168, 0, 1);
+    IPAddress subnet(255, 255, 255, 0);
+    WiFi.config(local_ip, dns_server, gateway, subnet);
+
+    for (uint16_t cycle = 0; cycle < RECONNECT_CYCLES; cycle++) {
+        reconnectCycle(staticPhaseMs, staticConnectMs);
+    }
+    TEST_ASSERT_EQUAL_UINT32(RECONNECT_CYCLES, staticConnectMs.count());
+}
+
+TEST_IFX(wifi_sta_reconnect, report_latency) {
+    printPhases("DHCP connect cycles", dhcpPhaseMs, dhcpConnectMs);
+    printPhases("Static IP connect cycles", staticPhaseMs, staticConnectMs);
+
+    Serial.print("DHCP cost: ");
+    Serial.print(dhcpConnectMs.mean() - staticConnectMs.mean(), 3);
+    Serial.println(" ms");
+}
+
+TEST_IFX(wifi_sta_reconnect, send_quit) {
+    IPAddress apIP(192, 168, 0, 1);
+
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, WiFi.begin("arduino-wifi-ap", "wifi-ap-password"));
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpProbe.begin(RECONNECT_ECHO_PORT));
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(udpProbe.beginPacket(apIP, RECONNECT_ECHO_PORT));
+        udpProbe.write('Q');
+        TEST_ASSERT_TRUE(udpProbe.endPacket());
+        delay(10);
+    }
+    udpProbe.stop();
+}
+
+TEST_IFX(wifi_sta_reconnect, disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_sta_reconnect, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_sta_reconnect) {
+    RUN_TEST_CASE(wifi_sta_reconnect, reconnect_cycles_dhcp);
+    RUN_TEST_CASE(wifi_sta_reconnect, reconnect_cycles_static_ip);
+    RUN_TEST_CASE(wifi_sta_reconnect, report_latency);
+    RUN_TEST_CASE(wifi_sta_reconnect, send_quit);
+    RUN_TEST_CASE(wifi_sta_reconnect, disconnect);
+    RUN_TEST_CASE(wifi_sta_reconnect, wifi_end);
+}
@@ -0,0 +1,260 @@
+/**
+ * @brief This test creates a WiFi (TCP) client which measures the TCP goodput
+ * to and from the server of the "test_wifi_throughput_server.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_throughput_server.cpp test
+ * - Connect to the server
+ * - Upload THROUGHPUT_PAYLOAD_BYTES with client.write(buf, n) for every chunk size
+ *   of throughputChunkSizes, and wait for the server acknowledge
+ * - Download THROUGHPUT_PAYLOAD_BYTES with client.read(buf, n) for every chunk size
+ *   of throughputChunkSizes, verifying the payload pattern
+ * - Report the goodput in kB/s (1 kB = 1000 bytes) per chunk size and direction,
+ *   and the smallest chunk size at which the throughput saturates, i.e. reaches
+ *   THROUGHPUT_SATURATION_PERCENT of the best measured goodput
+ * - Stop the client
+ * - Disconnect the wifi connection and end the WiFi
+ *
+ * The payload size can be overridden in the test_config.h of the board, e.g.
+ * for boards whose transfers are too slow for the default payload.
+ *
+ * This test is paired in the "test_wifi_throughput_server.cpp" test, which needs to be
+ * executed in a second board to provide the server to which the client connects to.
+ *
+ * @note This test must be run after the "test_wifi_throughput_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#ifndef THROUGHPUT_PAYLOAD_BYTES
+#define THROUGHPUT_PAYLOAD_BYTES        (2UL * 1024UL * 1024UL)
+#endif
+#define THROUGHPUT_PORT                 5001
+#define THROUGHPUT_MAX_CHUNK_SIZE       4096
+#define THROUGHPUT_TIMEOUT_MS           60000
+#define THROUGHPUT_REQUEST_SIZE         7 // command, chunk size (2 bytes), payload size (4 bytes)
+#define THROUGHPUT_SATURATION_PERCENT   95
+
+static const uint16_t throughputChunkSizes[] = {64, 128, 256, 512, 1024, 1460, 2048, 4096};
+#define THROUGHPUT_CHUNK_SIZES          (sizeof(throughputChunkSizes) / sizeof(throughputChunkSizes[0]))
+
+TEST_GROUP(wifi_throughput_client);
+
+static TEST_SETUP(wifi_throughput_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_throughput_client) {
+}
+
+WiFiClient client;
+
+static uint8_t chunk[THROUGHPUT_MAX_CHUNK_SIZE];
+static double uploadKBps[THROUGHPUT_CHUNK_SIZES];
+static double downloadKBps[THROUGHPUT_CHUNK_SIZES];
+
+/* Payload pattern shared with the server. 251 is prime, so the
+pattern never aligns with the chunk boundaries. The table repeats the
+pattern over one more chunk, so the payload at any offset is the slice
+starting at offset % PAYLOAD_PATTERN_PERIOD, built before the clock starts. */
+#define PAYLOAD_PATTERN_PERIOD          251
+
+static uint8_t payloadPattern[PAYLOAD_PATTERN_PERIOD + THROUGHPUT_MAX_CHUNK_SIZE];
+
+static void buildPayloadPattern() {
+    for (size_t i = 0; i < sizeof(payloadPattern); i++) {
+        payloadPattern[i] = (uint8_t)(i % PAYLOAD_PATTERN_PERIOD);
+    }
+}
+
+static inline const uint8_t *payloadSlice(uint32_t offset) {
+    return payloadPattern + offset % PAYLOAD_PATTERN_PERIOD;
+}
+
+static bool readExactly(uint8_t *buf, size_t len) {
+    size_t received = 0;
+    uint32_t start = millis();
+
+    while (received < len) {
+        int avail = client.available();
+        if (avail > 0) {
+            size_t request = len - received;
+            if ((size_t)avail < request) {
+                request = avail;
+            }
+            int read_bytes = client.read(buf + received, request);
+            if (read_bytes > 0) {
+                received += read_bytes;
+            }
+        } else if (!client.connected() || (millis() - start) > THROUGHPUT_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeAll(const uint8_t *buf, size_t len) {
+    size_t sent = 0;
+    uint32_t start = millis();
+
+    while (sent < len) {
+        sent += client.write(buf + sent, len - sent);
+        if (!client.connected() || (millis() - start) > THROUGHPUT_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sendRequest(char command, uint16_t chunkSize, uint32_t payloadSize) {
+    uint8_t request[THROUGHPUT_REQUEST_SIZE] = {
+        (uint8_t)command,
+        (uint8_t)(chunkSize & 0xFF), (uint8_t)(chunkSize >> 8),
+        (uint8_t)(payloadSize & 0xFF), (uint8_t)((payloadSize >> 8) & 0xFF),
+        (uint8_t)((payloadSize >> 16) & 0xFF), (uint8_t)(payloadSize >> 24)
+    };
+    TEST_ASSERT_TRUE_MESSAGE(writeAll(request, sizeof(request)), "Request not sent");
+}
+
+static double kBps(uint32_t bytes, uint32_t elapsed_us) {
+    if (elapsed_us == 0) {
+        elapsed_us = 1;
+    }
+    return (double)bytes * 1000.0 / (double)elapsed_us;
+}
+
+/**
+ * @brief Index of the smallest chunk size reaching THROUGHPUT_SATURATION_PERCENT
+ *        of the best goodput of the series.
+ */
+static uint8_t saturationIndex(const double *goodput) {
+    double best = 0;
+    for (uint8_t i = 0; i < THROUGHPUT_CHUNK_SIZES; i++) {
+        if (goodput[i] > best) {
+            best = goodput[i];
+        }
+    }
+    for (uint8_t i = 0; i < THROUGHPUT_CHUNK_SIZES; i++) {
+        if (goodput[i] * 100.0 >= best * THROUGHPUT_SATURATION_PERCENT) {
+            return i;
+        }
+    }
+    return THROUGHPUT_CHUNK_SIZES - 1;
+}
+
+TEST_IFX(wifi_throughput_client, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_throughput_client, client_connect) {
+    IPAddress ip(192, 168, 0, 1);
+    TEST_ASSERT_TRUE(client.connect(ip, THROUGHPUT_PORT));
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_CONNECTED, client.status());
+}
+
+TEST_IFX(wifi_throughput_client, client_upload_throughput) {
+    for (uint8_t i = 0; i < THROUGHPUT_CHUNK_SIZES; i++) {
+        uint16_t chunkSize = throughputChunkSizes[i];
+        uint32_t offset = 0;
+
+        buildPayloadPattern();
+        sendRequest('U', chunkSize, THROUGHPUT_PAYLOAD_BYTES);
+
+        uint32_t start = micros();
+        while (offset < THROUGHPUT_PAYLOAD_BYTES) {
+            size_t len = THROUGHPUT_PAYLOAD_BYTES - offset;
+            if (len > chunkSize) {
+                len = chunkSize;
+            }
+            TEST_ASSERT_TRUE_MESSAGE(writeAll(payloadSlice(offset), len), "Upload payload incomplete");
+            offset += len;
+        }
+
+        /* The goodput counts until the server confirmed the complete payload */
+        uint8_t ack = 0;
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(&ack, 1), "No upload acknowledge");
+        uploadKBps[i] = kBps(THROUGHPUT_PAYLOAD_BYTES, micros() - start);
+        TEST_ASSERT_EQUAL_CHAR('A', ack);
+    }
+}
+
+TEST_IFX(wifi_throughput_client, client_download_throughput) {
+    for (uint8_t i = 0; i < THROUGHPUT_CHUNK_SIZES; i++) {
+        uint16_t chunkSize = throughputChunkSizes[i];
+        uint32_t offset = 0;
+        uint32_t errors = 0; // corrupted chunks
+
+        buildPayloadPattern();
+        uint32_t start = micros();
+        sendRequest('D', chunkSize, THROUGHPUT_PAYLOAD_BYTES);
+
+        while (offset < THROUGHPUT_PAYLOAD_BYTES) {
+            size_t len = THROUGHPUT_PAYLOAD_BYTES - offset;
+            if (len > chunkSize) {
+                len = chunkSize;
+            }
+            TEST_ASSERT_TRUE_MESSAGE(readExactly(chunk, len), "Download payload incomplete");
+            if (memcmp(chunk, payloadSlice(offset), len) != 0) {
+                errors++;
+            }
+            offset += len;
+        }
+        downloadKBps[i] = kBps(THROUGHPUT_PAYLOAD_BYTES, micros() - start);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, "Download payload corrupted");
+    }
+}
+
+TEST_IFX(wifi_throughput_client, client_report_throughput) {
+    Serial.print("\nTCP goodput, payload ");
+    Serial.print((unsigned long)THROUGHPUT_PAYLOAD_BYTES);
+    Serial.println(" bytes per chunk size");
+    Serial.println("chunk [B]\tupload [kB/s]\tdownload [kB/s]");
+    for (uint8_t i = 0; i < THROUGHPUT_CHUNK_SIZES; i++) {
+        Serial.print(throughputChunkSizes[i]);
+        Serial.print("\t\t");
+        Serial.print(uploadKBps[i], 1);
+        Serial.print("\t\t");
+        Serial.println(downloadKBps[i], 1);
+
+        TEST_ASSERT_TRUE(uploadKBps[i] > 0);
+        TEST_ASSERT_TRUE(downloadKBps[i] > 0);
+    }
+
+    Serial.print("Upload saturates at chunk size ");
+    Serial.print(throughputChunkSizes[saturationIndex(uploadKBps)]);
+    Serial.println(" B");
+    Serial.print("Download saturates at chunk size ");
+    Serial.print(throughputChunkSizes[saturationIndex(downloadKBps)]);
+    Serial.println(" B");
+}
+
+TEST_IFX(wifi_throughput_client, client_stop) {
+    sendRequest('Q', 0, 0);
+    client.stop();
+    TEST_ASSERT_FALSE(client.connected());
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, client.status());
+}
+
+TEST_IFX(wifi_throughput_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_throughput_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_throughput_client) {
+    RUN_TEST_CASE(wifi_throughput_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_throughput_client, client_connect);
+    RUN_TEST_CASE(wifi_throughput_client, client_upload_throughput);
+    RUN_TEST_CASE(wifi_throughput_client, client_download_throughput);
+    RUN_TEST_CASE(wifi_throughput_client, client_report_throughput);
+    RUN_TEST_CASE(wifi_throughput_client, client_stop);
+    RUN_TEST_CASE(wifi_throughput_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_throughput_client, wifi_end);
+}
@@ -0,0 +1,217 @@
+/**
+ * @brief This test starts a WiFi (TCP) server which serves the throughput
+ * benchmark requests of the "test_wifi_throughput_client.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Start the access point
+ * - Start the server
+ * - Wait for the benchmark client to connect
+ * - Serve the client requests until it quits:
+ *   - 'U' (upload): receive and verify the announced payload in reads of the
+ *     announced chunk size, then acknowledge it with one byte
+ *   - 'D' (download): send the announced payload in writes of the announced
+ *     chunk size
+ * - Stop the server
+ * - Disconnect the WiFi connection
+ * - End the WiFi
+ *
+ * The receive goodput per chunk size is printed for the upload direction as
+ * seen by the server. The client reports both directions.
+ *
+ * This test is paired in the "test_wifi_throughput_client.cpp" test, which needs to be
+ * executed in a second board to operate the benchmark client.
+ *
+ * @note This test must be run before the "test_wifi_throughput_client.cpp" test.
+ */
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiServer.h>
+
+#define THROUGHPUT_PORT            5001
+#define THROUGHPUT_MAX_CHUNK_SIZE  4096
+#define THROUGHPUT_TIMEOUT_MS      60000
+#define THROUGHPUT_REQUEST_SIZE    7 // command, chunk size (2 bytes), payload size (4 bytes)
+
+TEST_GROUP(wifi_throughput_server);
+
+static TEST_SETUP(wifi_throughput_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_throughput_server) {
+}
+
+WiFiServer server;
+WiFiClient client;
+
+static uint8_t chunk[THROUGHPUT_MAX_CHUNK_SIZE];
+
+/* Payload pattern shared with the client. 251 is prime, so the
+pattern never aligns with the chunk boundaries. The table repeats the
+pattern over one more chunk, so the payload at any offset is the slice
+starting at offset % PAYLOAD_PATTERN_PERIOD, built before the clock starts. */
+#define PAYLOAD_PATTERN_PERIOD          251
+
+static uint8_t payloadPattern[PAYLOAD_PATTERN_PERIOD + THROUGHPUT_MAX_CHUNK_SIZE];
+
+static void buildPayloadPattern() {
+    for (size_t i = 0; i < sizeof(payloadPattern); i++) {
+        payloadPattern[i] = (uint8_t)(i % PAYLOAD_PATTERN_PERIOD);
+    }
+}
+
+static inline const uint8_t *payloadSlice(uint32_t offset) {
+    return payloadPattern + offset % PAYLOAD_PATTERN_PERIOD;
+}
+
+static bool readExactly(uint8_t *buf, size_t len) {
+    size_t received = 0;
+    uint32_t start = millis();
+
+    while (received < len) {
+        int avail = client.available();
+        if (avail > 0) {
+            size_t request = len - received;
+            if ((size_t)avail < request) {
+                request = avail;
+            }
+            int read_bytes = client.read(buf + received, request);
+            if (read_bytes > 0) {
+                received += read_bytes;
+            }
+        } else if (!client.connected() || (millis() - start) > THROUGHPUT_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeAll(const uint8_t *buf, size_t len) {
+    size_t sent = 0;
+    uint32_t start = millis();
+
+    while (sent < len) {
+        sent += client.write(buf + sent, len - sent);
+        if (!client.connected() || (millis() - start) > THROUGHPUT_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void serveUpload(uint16_t chunkSize, uint32_t payloadSize) {
+    uint32_t offset = 0;
+    uint32_t errors = 0; // corrupted chunks
+
+    /* No receive rate here: the payload is mostly queued in the socket
+    before the request is parsed, the client reports the goodput */
+    buildPayloadPattern();
+    while (offset < payloadSize) {
+        size_t len = payloadSize - offset;
+        if (len > chunkSize) {
+            len = chunkSize;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(chunk, len), "Upload payload incomplete");
+        if (memcmp(chunk, payloadSlice(offset), len) != 0) {
+            errors++;
+        }
+        offset += len;
+    }
+
+    const uint8_t ack = 'A';
+    TEST_ASSERT_TRUE(writeAll(&ack, 1));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, "Upload payload corrupted");
+}
+
+static void serveDownload(uint16_t chunkSize, uint32_t payloadSize) {
+    uint32_t offset = 0;
+
+    buildPayloadPattern();
+    while (offset < payloadSize) {
+        size_t len = payloadSize - offset;
+        if (len > chunkSize) {
+            len = chunkSize;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(writeAll(payloadSlice(offset), len), "Download payload incomplete");
+        offset += len;
+    }
+}
+
+TEST_IFX(wifi_throughput_server, wifi_begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_throughput_server, server_begin) {
+    server.begin(THROUGHPUT_PORT);
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_LISTENING, server.status());
+}
+
+TEST_IFX(wifi_throughput_server, server_available) {
+    /* The client sends its first request right
+    after connecting, which makes it available */
+    do {
+        client = server.available();
+    } while(!client);
+
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_CONNECTED, client.status());
+}
+
+TEST_IFX(wifi_throughput_server, server_serve_requests) {
+    uint8_t request[THROUGHPUT_REQUEST_SIZE];
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE(readExactly(request, sizeof(request)), "No request from client");
+
+        uint16_t chunkSize = (uint16_t)(request[1] | (request[2] << 8));
+        uint32_t payloadSize = (uint32_t)request[3] | ((uint32_t)request[4] << 8) |
+                               ((uint32_t)request[5] << 16) | ((uint32_t)request[6] << 24);
+
+        switch (request[0]) {
+            case 'U':
+                TEST_ASSERT_TRUE(chunkSize > 0 && chunkSize <= THROUGHPUT_MAX_CHUNK_SIZE);
+                serveUpload(chunkSize, payloadSize);
+                break;
+            case 'D':
+                TEST_ASSERT_TRUE(chunkSize > 0 && chunkSize <= THROUGHPUT_MAX_CHUNK_SIZE);
+                serveDownload(chunkSize, payloadSize);
+                break;
+            case 'Q':
+                quit = true;
+                break;
+            default:
+                TEST_FAIL_MESSAGE("Unknown request");
+                break;
+        }
+    }
+}
+
+TEST_IFX(wifi_throughput_server, server_end) {
+    /* Wait until the client is disconnected
+    from the other side */
+    while(server.connectedSize() > 0) { }
+
+    server.end();
+    TEST_ASSERT_EQUAL_UINT8(SOCKET_STATUS_DELETED, server.status());
+}
+
+TEST_IFX(wifi_throughput_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_throughput_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_UINT8(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_throughput_server) {
+    RUN_TEST_CASE(wifi_throughput_server, wifi_begin_ap);
+    RUN_TEST_CASE(wifi_throughput_server, server_begin);
+    RUN_TEST_CASE(wifi_throughput_server, server_available);
+    RUN_TEST_CASE(wifi_throughput_server, server_serve_requests);
+    RUN_TEST_CASE(wifi_throughput_server, server_end);
+    RUN_TEST_CASE(wifi_throughput_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_throughput_server, wifi_end);
+}
@@ -0,0 +1,167 @@
+/**
+ * @file test_wifi_udp_benchmark_client.cpp
+ * @brief This test creates a WiFi (UDP) client which sends series of sequence-numbered
+ * datagrams at a controlled rate to the "test_wifi_udp_benchmark_server.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_udp_benchmark_server.cpp test
+ * - Starts WiFiUDP socket, listening at local port UDP_BENCH_PORT.
+ * - For every size of udpBenchSizes (16 bytes up to the MTU payload) sends
+ *   UDP_BENCH_PACKETS datagrams paced to UDP_BENCH_RATE_PPS, followed by the end packets
+ *   of the series carrying the number of datagrams sent and the send window
+ * - Reports the achieved send rate and the failed endPacket() calls per size
+ * - Sends the quit packets and stops the UDP client.
+ * - Disconnect the wifi connection and end the WiFi
+ *
+ * UDP_BENCH_PACKETS and UDP_BENCH_RATE_PPS can be overridden in the test_config.h of
+ * the board. A rate of 0 sends as fast as the stack accepts the datagrams. The
+ * datagram layout is described in test_wifi_udp_benchmark_server.cpp.
+ *
+ *  This test is paired with the "test_wifi_udp_benchmark_server.cpp" test, which needs to be
+ *  executed in another board to receive and evaluate the datagrams.
+ *
+ * @note This test must be run after the "test_wifi_udp_benchmark_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef UDP_BENCH_PACKETS
+#define UDP_BENCH_PACKETS           1000
+#endif
+#ifndef UDP_BENCH_RATE_PPS
+#define UDP_BENCH_RATE_PPS          500
+#endif
+#define UDP_BENCH_PORT              5003
+#define UDP_BENCH_MAX_SIZE          1472  // MTU 1500 - IP header - UDP header
+#define UDP_BENCH_CONTROL_REPEAT    3     // control packets are repeated against loss
+#define UDP_BENCH_SERIES_GAP_MS     200
+
+static const uint16_t udpBenchSizes[] = {16, 64, 128, 256, 512, 1024, UDP_BENCH_MAX_SIZE};
+#define UDP_BENCH_SIZES             (sizeof(udpBenchSizes) / sizeof(udpBenchSizes[0]))
+
+TEST_GROUP(wifi_udp_benchmark_client);
+
+static TEST_SETUP(wifi_udp_benchmark_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_benchmark_client) {
+}
+
+WiFiUDP udpClient;
+
+static uint8_t packet[UDP_BENCH_MAX_SIZE];
+
+static inline void writeUint32(uint8_t *buf, uint32_t value) {
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    buf[3] = (uint8_t)(value >> 24);
+}
+
+static bool sendPacket(const uint8_t *buf, size_t len) {
+    IPAddress ip(192, 168, 0, 1);
+
+    if (!udpClient.beginPacket(ip, UDP_BENCH_PORT)) {
+        return false;
+    }
+    if (udpClient.write(buf, len) != len) {
+        return false;
+    }
+    return udpClient.endPacket();
+}
+
+static void sendControl(char type, uint8_t index, uint32_t value, uint32_t elapsedUs = 0) {
+    uint8_t control[10] = {(uint8_t)type, index};
+    writeUint32(&control[2], value);
+    writeUint32(&control[6], elapsedUs);
+
+    for (uint8_t i = 0; i < UDP_BENCH_CONTROL_REPEAT; i++) {
+        sendPacket(control, sizeof(control));
+        delay(10);
+    }
+}
+
+TEST_IFX(wifi_udp_benchmark_client, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_udp_benchmark_client, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpClient.begin(UDP_BENCH_PORT));
+}
+
+TEST_IFX(wifi_udp_benchmark_client, udp_send_series) {
+    const uint32_t intervalUs = UDP_BENCH_RATE_PPS > 0 ? MICROSECONDS_PER_SECOND / UDP_BENCH_RATE_PPS : 0;
+
+    Serial.print("\nTarget rate: ");
+    Serial.print((unsigned long)UDP_BENCH_RATE_PPS);
+    Serial.println(" packets/s (0 = unlimited)");
+    Serial.println("size [B]\tsent packets/s\tsend failures");
+
+    for (uint8_t index = 0; index < UDP_BENCH_SIZES; index++) {
+        uint16_t size = udpBenchSizes[index];
+        uint32_t sent = 0;
+        uint32_t failures = 0;
+
+        for (uint16_t i = 6; i < size; i++) {
+            packet[i] = (uint8_t)i;
+        }
+        packet[0] = 'D';
+        packet[1] = index;
+
+        uint32_t start = micros();
+        for (uint32_t seq = 0; seq < UDP_BENCH_PACKETS; seq++) {
+            /* Pace on the absolute schedule, so a late datagram
+            does not shift all following ones */
+            while ((micros() - start) < seq * intervalUs) { }
+
+            writeUint32(&packet[2], seq);
+            if (sendPacket(packet, size)) {
+                sent++;
+            } else {
+                failures++;
+            }
+        }
+        uint32_t elapsed = micros() - start;
+
+        delay(UDP_BENCH_SERIES_GAP_MS);
+        sendControl('E', index, sent, elapsed);
+        delay(UDP_BENCH_SERIES_GAP_MS);
+
+        Serial.print(size);
+        Serial.print("\t\t");
+        Serial.print(elapsed > 0 ? (double)sent * MICROSECONDS_PER_SECOND / (double)elapsed : 0.0, 1);
+        Serial.print("\t\t");
+        Serial.println(failures);
+
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, sent, "No datagram sent for a size");
+    }
+
+    sendControl('Q', 0, 0);
+}
+
+TEST_IFX(wifi_udp_benchmark_client, udp_client_end) {
+    udpClient.stop();
+}
+
+TEST_IFX(wifi_udp_benchmark_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_benchmark_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_benchmark_client) {
+    RUN_TEST_CASE(wifi_udp_benchmark_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_udp_benchmark_client, udp_begin);
+    RUN_TEST_CASE(wifi_udp_benchmark_client, udp_send_series);
+    RUN_TEST_CASE(wifi_udp_benchmark_client, udp_client_end);
+    RUN_TEST_CASE(wifi_udp_benchmark_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_benchmark_client, wifi_end);
+}
@@ -0,0 +1,213 @@
+/**
+ * @file test_wifi_udp_benchmark_server.cpp
+ * @brief This test creates a WiFi (UDP) server which receives the sequence-numbered
+ * datagrams of the "test_wifi_udp_benchmark_client.cpp" test and reports the packet
+ * rate and the transmission defects per datagram size.
+ *
+ * @details The tests runs the following sequence:
+ * - Creates an WiFi access point to which the client connects
+ * - Starts WiFiUDP socket, listening at local port UDP_BENCH_PORT.
+ * - Receives the datagram series of every size until the client quits. Each series is
+ *   closed by an end packet carrying the number of datagrams sent by the client.
+ * - Reports per size: packets/s, goodput, loss %, reordered and duplicated datagrams.
+ *   The rates are the received datagrams per second of the client's send window, the
+ *   arrival times would include the datagrams queued in the socket.
+ * - Stops the UDP server
+ * - Disconnect from the client and stop the access point.
+ *
+ * Datagram layout, all integers little endian:
+ * - byte 0: packet type, 'D' data, 'E' end of series, 'Q' quit
+ * - byte 1: index of the series (datagram size)
+ * - byte 2..5: sequence number ('D') or number of sent datagrams ('E')
+ * - byte 6..9: send window of the series in us ('E')
+ * - byte 6..: payload pattern ('D')
+ *
+ * This test is paired with the "test_wifi_udp_benchmark_client.cpp" test, which needs to be
+ * executed in another board to operate the client sending the datagrams.
+ *
+ * @note This test must be run before the "test_wifi_udp_benchmark_client.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef UDP_BENCH_PACKETS
+#define UDP_BENCH_PACKETS           1000
+#endif
+#define UDP_BENCH_PORT              5003
+#define UDP_BENCH_MAX_SIZE          1472  // MTU 1500 - IP header - UDP header
+#define UDP_BENCH_MAX_SERIES        16
+#define UDP_BENCH_IDLE_TIMEOUT_MS   60000
+
+TEST_GROUP(wifi_udp_benchmark_server);
+
+static TEST_SETUP(wifi_udp_benchmark_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_benchmark_server) {
+}
+
+WiFiUDP udpServer;
+
+typedef struct {
+    uint16_t size;
+    uint32_t sent;
+    uint32_t received;
+    uint32_t reordered;
+    uint32_t duplicates;
+    uint32_t sendUs;
+    bool closed;
+} udp_series_t;
+
+static udp_series_t series[UDP_BENCH_MAX_SERIES];
+static uint8_t seriesCount = 0;
+
+static uint8_t packet[UDP_BENCH_MAX_SIZE];
+static uint8_t seen[(UDP_BENCH_PACKETS + 7) / 8];
+static int16_t currentSeries = -1;
+static uint32_t highestSeq = 0;
+
+static inline uint32_t readUint32(const uint8_t *buf) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static void openSeries(uint8_t index, uint16_t size) {
+    currentSeries = index;
+    highestSeq = 0;
+    memset(seen, 0, sizeof(seen));
+    memset(&series[index], 0, sizeof(series[index]));
+    series[index].size = size;
+    series[index].sent = UDP_BENCH_PACKETS;
+    if (index >= seriesCount) {
+        seriesCount = index + 1;
+    }
+}
+
+static void receiveData(uint8_t index, uint32_t seq, uint16_t size) {
+    if (index != currentSeries) {
+        openSeries(index, size);
+    }
+    udp_series_t &s = series[index];
+
+    if (seq >= UDP_BENCH_PACKETS) {
+        return;
+    }
+    if (seen[seq / 8] & (1 << (seq % 8))) {
+        s.duplicates++;
+        return;
+    }
+    seen[seq / 8] |= (1 << (seq % 8));
+
+    if (s.received > 0 && seq < highestSeq) {
+        s.reordered++;
+    }
+    if (seq > highestSeq) {
+        highestSeq = seq;
+    }
+    s.received++;
+}
+
+TEST_IFX(wifi_udp_benchmark_server, begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_udp_benchmark_server, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpServer.begin(UDP_BENCH_PORT));
+}
+
+TEST_IFX(wifi_udp_benchmark_server, udp_receive_series) {
+    uint32_t lastPacket = millis();
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastPacket) < UDP_BENCH_IDLE_TIMEOUT_MS, "No datagram from client");
+
+        int packetSize = udpServer.parsePacket();
+        if (packetSize <= 0) {
+            continue;
+        }
+        lastPacket = millis();
+
+        int read_bytes = udpServer.read(packet, sizeof(packet));
+        if (read_bytes < 6 || packet[1] >= UDP_BENCH_MAX_SERIES) {
+            continue;
+        }
+
+        switch (packet[0]) {
+            case 'D':
+                receiveData(packet[1], readUint32(&packet[2]), (uint16_t)packetSize);
+                break;
+            case 'E':
+                /* The end packet is repeated by the client, only the first one counts */
+                if (packet[1] == currentSeries && !series[currentSeries].closed) {
+                    series[currentSeries].sent = readUint32(&packet[2]);
+                    if (read_bytes >= 10) {
+                        series[currentSeries].sendUs = readUint32(&packet[6]);
+                    }
+                    series[currentSeries].closed = true;
+                }
+                break;
+            case 'Q':
+                quit = true;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+TEST_IFX(wifi_udp_benchmark_server, udp_report_series) {
+    Serial.println("\nsize [B]\tpackets/s\tkB/s\t\tloss [%]\treordered\tduplicates");
+
+    for (uint8_t i = 0; i < seriesCount; i++) {
+        const udp_series_t &s = series[i];
+        double pps = 0;
+        if (s.sendUs > 0) {
+            pps = (double)s.received * MICROSECONDS_PER_SECOND / (double)s.sendUs;
+        }
+        double loss = s.sent > 0 ? 100.0 * (double)(s.sent - s.received) / (double)s.sent : 0;
+
+        Serial.print(s.size);
+        Serial.print("\t\t");
+        Serial.print(pps, 1);
+        Serial.print("\t\t");
+        Serial.print(pps * s.size / 1000.0, 1);
+        Serial.print("\t\t");
+        Serial.print(loss, 2);
+        Serial.print("\t\t");
+        Serial.print(s.reordered);
+        Serial.print("\t\t");
+        Serial.println(s.duplicates);
+
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, s.received, "No datagram received for a size");
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(s.sent, s.received);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT8(0, seriesCount);
+}
+
+TEST_IFX(wifi_udp_benchmark_server, udp_server_end) {
+    udpServer.stop();
+}
+
+TEST_IFX(wifi_udp_benchmark_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_benchmark_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_benchmark_server) {
+    RUN_TEST_CASE(wifi_udp_benchmark_server, begin_ap);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, udp_begin);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, udp_receive_series);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, udp_report_series);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, udp_server_end);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_benchmark_server, wifi_end);
+}
@@ -0,0 +1,246 @@
+/**
+ * @file test_wifi_udp_multicast_receiver.cpp
+ * @brief This test creates a WiFi (UDP) multicast receiver which measures the sustained
+ * multicast receive rate while handling unicast traffic on the same socket, and the
+ * cost of joining and leaving multicast groups.
+ *
+ * @details The tests runs the following sequence:
+ * - Creates an WiFi access point to which the sender connects
+ * - Joins and leaves MCAST_GROUPS multicast groups, timing beginMulticast() and stop()
+ * - Joins the multicast group 239.0.0.1 at port MCAST_PORT
+ * - Receives the multicast and unicast datagram series of the sender, one series per
+ *   multicast send rate, until the sender quits
+ * - Reports per series: multicast and unicast packets/s and loss %, duplicates, and the
+ *   receive ceiling, i.e. the highest multicast rate received with at most
+ *   MCAST_MAX_LOSS_PERCENT loss. The rates are the received datagrams per second of the
+ *   sender's send window, the arrival times would include the datagrams queued in the socket
+ * - Stops the UDP socket
+ * - Disconnect from the sender and stop the access point.
+ *
+ * Datagram layout, all integers little endian:
+ * - byte 0: packet type, 'M' multicast data, 'U' unicast data, 'E' end of series, 'Q' quit
+ * - byte 1: index of the series
+ * - byte 2..5: sequence number ('M', 'U') or number of sent multicast datagrams ('E')
+ * - byte 6..9: number of sent unicast datagrams ('E')
+ * - byte 10..13: send window of the series in us ('E')
+ *
+ * This test is paired with the "test_wifi_udp_multicast_sender.cpp" test, which needs to be
+ * executed in another board to send the datagrams.
+ *
+ * @note This test must be run before the "test_wifi_udp_multicast_sender.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef MCAST_PACKETS
+#define MCAST_PACKETS               1000
+#endif
+#define MCAST_PORT                  5004
+#define MCAST_GROUPS                8
+#define MCAST_MAX_SIZE              1472
+#define MCAST_MAX_SERIES            16
+#define MCAST_MAX_LOSS_PERCENT      1.0
+#define MCAST_IDLE_TIMEOUT_MS       60000
+
+TEST_GROUP(wifi_udp_multicast_receiver);
+
+static TEST_SETUP(wifi_udp_multicast_receiver) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_multicast_receiver) {
+}
+
+WiFiUDP udpReceiver;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t duplicates;
+    uint8_t seen[(MCAST_PACKETS + 7) / 8];
+} mcast_stream_t;
+
+typedef struct {
+    mcast_stream_t multicast;
+    mcast_stream_t unicast;
+    uint32_t sendUs;
+    bool closed;
+} mcast_series_t;
+
+static mcast_series_t series[MCAST_MAX_SERIES];
+static uint8_t seriesCount = 0;
+static uint8_t packet[MCAST_MAX_SIZE];
+
+static inline uint32_t readUint32(const uint8_t *buf) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static void receiveData(mcast_stream_t &stream, uint32_t seq) {
+    if (seq >= MCAST_PACKETS) {
+        return;
+    }
+    if (stream.seen[seq / 8] & (1 << (seq % 8))) {
+        stream.duplicates++;
+        return;
+    }
+    stream.seen[seq / 8] |= (1 << (seq % 8));
+    stream.received++;
+}
+
+static double streamRate(const mcast_stream_t &stream, uint32_t sendUs) {
+    if (sendUs == 0) {
+        return 0;
+    }
+    return (double)stream.received * MICROSECONDS_PER_SECOND / (double)sendUs;
+}
+
+static double streamLoss(const mcast_stream_t &stream) {
+    if (stream.sent == 0 || stream.received >= stream.sent) {
+        return 0;
+    }
+    return 100.0 * (double)(stream.sent - stream.received) / (double)stream.sent;
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, join_leave_groups) {
+    static WiFiUDP groupSockets[MCAST_GROUPS];
+    RunningStats joinUs;
+    RunningStats leaveUs;
+
+    for (uint8_t i = 0; i < MCAST_GROUPS; i++) {
+        IPAddress group(239, 0, 1, i + 1);
+        uint32_t start = micros();
+        TEST_ASSERT_TRUE(groupSockets[i].beginMulticast(group, MCAST_PORT + 1 + i));
+        joinUs.add(micros() - start);
+    }
+
+    for (uint8_t i = 0; i < MCAST_GROUPS; i++) {
+        uint32_t start = micros();
+        groupSockets[i].stop();
+        leaveUs.add(micros() - start);
+    }
+
+    Serial.println();
+    joinUs.print("Join group (beginMulticast)", "us");
+    leaveUs.print("Leave group (stop)", "us");
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, begin_multicast) {
+    IPAddress multicastIP(239, 0, 0, 1);
+    TEST_ASSERT_TRUE(udpReceiver.beginMulticast(multicastIP, MCAST_PORT));
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, receive_series) {
+    uint32_t lastPacket = millis();
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastPacket) < MCAST_IDLE_TIMEOUT_MS, "No datagram from sender");
+
+        int packetSize = udpReceiver.parsePacket();
+        if (packetSize <= 0) {
+            continue;
+        }
+        lastPacket = millis();
+
+        int read_bytes = udpReceiver.read(packet, sizeof(packet));
+        if (read_bytes < 6 || packet[1] >= MCAST_MAX_SERIES) {
+            continue;
+        }
+
+        mcast_series_t &s = series[packet[1]];
+        if (packet[1] >= seriesCount) {
+            seriesCount = packet[1] + 1;
+        }
+
+        switch (packet[0]) {
+            case 'M':
+                receiveData(s.multicast, readUint32(&packet[2]));
+                break;
+            case 'U':
+                receiveData(s.unicast, readUint32(&packet[2]));
+                break;
+            case 'E':
+                /* The end packet is repeated by the sender, only the first one counts */
+                if (!s.closed && read_bytes >= 14) {
+                    s.multicast.sent = readUint32(&packet[2]);
+                    s.unicast.sent = readUint32(&packet[6]);
+                    s.sendUs = readUint32(&packet[10]);
+                    s.closed = true;
+                }
+                break;
+            case 'Q':
+                quit = true;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, report_series) {
+    double ceiling = 0;
+
+    Serial.println("\nseries\tmcast packets/s\tmcast loss [%]\tucast packets/s\tucast loss [%]\tduplicates");
+    for (uint8_t i = 0; i < seriesCount; i++) {
+        const mcast_series_t &s = series[i];
+        double mcastRate = streamRate(s.multicast, s.sendUs);
+        double mcastLoss = streamLoss(s.multicast);
+
+        Serial.print(i);
+        Serial.print("\t");
+        Serial.print(mcastRate, 1);
+        Serial.print("\t\t");
+        Serial.print(mcastLoss, 2);
+        Serial.print("\t\t");
+        Serial.print(streamRate(s.unicast, s.sendUs), 1);
+        Serial.print("\t\t");
+        Serial.print(streamLoss(s.unicast), 2);
+        Serial.print("\t\t");
+        Serial.println(s.multicast.duplicates + s.unicast.duplicates);
+
+        if (mcastLoss <= MCAST_MAX_LOSS_PERCENT && mcastRate > ceiling) {
+            ceiling = mcastRate;
+        }
+
+        TEST_ASSERT_TRUE_MESSAGE(s.closed, "End of series not received");
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, s.multicast.received, "No multicast datagram received");
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, s.unicast.received, "No unicast datagram received");
+    }
+
+    Serial.print("Multicast receive ceiling: ");
+    Serial.print(ceiling, 1);
+    Serial.println(" packets/s");
+    TEST_ASSERT_GREATER_THAN_UINT8(0, seriesCount);
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, udp_receiver_end) {
+    udpReceiver.stop();
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_multicast_receiver, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_multicast_receiver) {
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, begin_ap);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, join_leave_groups);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, begin_multicast);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, receive_series);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, report_series);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, udp_receiver_end);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_multicast_receiver, wifi_end);
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_wifi_udp_multicast_sender.cpp
+ * @brief This test creates a WiFi (UDP) sender which streams multicast datagrams to the
+ * group 239.0.0.1, interleaved with unicast datagrams to the same port of the
+ * "test_wifi_udp_multicast_receiver.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_udp_multicast_receiver.cpp test
+ * - Starts WiFiUDP socket, listening at local port MCAST_PORT.
+ * - For every rate of multicastRates sends MCAST_PACKETS multicast datagrams of
+ *   MCAST_SIZE bytes, and one unicast datagram to the receiver after every
+ *   MCAST_UNICAST_RATIO multicast datagrams, followed by the end packets of the series
+ *   carrying the sent datagrams and the send window
+ * - Sends the quit packets and stops the UDP socket.
+ * - Disconnect the wifi connection and end the WiFi
+ *
+ * A rate of 0 sends as fast as the stack accepts the datagrams. The datagram layout
+ * is described in test_wifi_udp_multicast_receiver.cpp.
+ *
+ *  This test is paired with the "test_wifi_udp_multicast_receiver.cpp" test, which needs to be
+ *  executed in another board to receive and evaluate the datagrams.
+ *
+ * @note This test must be run after the "test_wifi_udp_multicast_receiver.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef MCAST_PACKETS
+#define MCAST_PACKETS               1000
+#endif
+#define MCAST_PORT                  5004
+#define MCAST_SIZE                  256
+#define MCAST_UNICAST_RATIO         4
+#define MCAST_CONTROL_REPEAT        3     // control packets are repeated against loss
+#define MCAST_SERIES_GAP_MS         200
+
+static const uint16_t multicastRates[] = {100, 250, 500, 1000, 2000, 0};
+#define MCAST_RATES                 (sizeof(multicastRates) / sizeof(multicastRates[0]))
+
+TEST_GROUP(wifi_udp_multicast_sender);
+
+static TEST_SETUP(wifi_udp_multicast_sender) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_multicast_sender) {
+}
+
+WiFiUDP udpSender;
+
+static uint8_t packet[MCAST_SIZE];
+
+static inline void writeUint32(uint8_t *buf, uint32_t value) {
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    buf[3] = (uint8_t)(value >> 24);
+}
+
+static bool sendPacket(const IPAddress &ip, const uint8_t *buf, size_t len) {
+    if (!udpSender.beginPacket(ip, MCAST_PORT)) {
+        return false;
+    }
+    if (udpSender.write(buf, len) != len) {
+        return false;
+    }
+    return udpSender.endPacket();
+}
+
+static void sendControl(char type, uint8_t index, uint32_t multicastSent, uint32_t unicastSent, uint32_t elapsedUs) {
+    IPAddress receiverIP(192, 168, 0, 1);
+    uint8_t control[14] = {(uint8_t)type, index};
+    writeUint32(&control[2], multicastSent);
+    writeUint32(&control[6], unicastSent);
+    writeUint32(&control[10], elapsedUs);
+
+    for (uint8_t i = 0; i < MCAST_CONTROL_REPEAT; i++) {
+        sendPacket(receiverIP, control, sizeof(control));
+        delay(10);
+    }
+}
+
+TEST_IFX(wifi_udp_multicast_sender, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_udp_multicast_sender, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpSender.begin(MCAST_PORT));
+}
+
+TEST_IFX(wifi_udp_multicast_sender, send_series) {
+    IPAddress multicastIP(239, 0, 0, 1);
+    IPAddress receiverIP(192, 168, 0, 1);
+
+    for (uint16_t i = 6; i < MCAST_SIZE; i++) {
+        packet[i] = (uint8_t)i;
+    }
+
+    Serial.println("\nseries\ttarget packets/s\tsent packets/s\tsend failures");
+    for (uint8_t index = 0; index < MCAST_RATES; index++) {
+        const uint32_t intervalUs = multicastRates[index] > 0 ? MICROSECONDS_PER_SECOND / multicastRates[index] : 0;
+        uint32_t multicastSent = 0;
+        uint32_t unicastSent = 0;
+        uint32_t failures = 0;
+
+        packet[1] = index;
+        uint32_t start = micros();
+        for (uint32_t seq = 0; seq < MCAST_PACKETS; seq++) {
+            /* Pace on the absolute schedule, so a late datagram
+            does not shift all following ones */
+            while ((micros() - start) < seq * intervalUs) { }
+
+            packet[0] = 'M';
+            writeUint32(&packet[2], seq);
+            if (sendPacket(multicastIP, packet, MCAST_SIZE)) {
+                multicastSent++;
+            } else {
+                failures++;
+            }
+
+            if ((seq % MCAST_UNICAST_RATIO) == 0) {
+                packet[0] = 'U';
+                writeUint32(&packet[2], seq / MCAST_UNICAST_RATIO);
+                if (sendPacket(receiverIP, packet, MCAST_SIZE)) {
+                    unicastSent++;
+                } else {
+                    failures++;
+                }
+            }
+        }
+        uint32_t elapsed = micros() - start;
+
+        delay(MCAST_SERIES_GAP_MS);
+        sendControl('E', index, multicastSent, unicastSent, elapsed);
+        delay(MCAST_SERIES_GAP_MS);
+
+        Serial.print(index);
+        Serial.print("\t");
+        Serial.print(multicastRates[index]);
+        Serial.print("\t\t\t");
+        Serial.print(elapsed > 0 ? (double)multicastSent * MICROSECONDS_PER_SECOND / (double)elapsed : 0.0, 1);
+        Serial.print("\t\t");
+        Serial.println(failures);
+
+        TEST_ASSERT_GREATER_THAN_UINT32_MESSAGE(0, multicastSent, "No multicast datagram sent");
+    }
+
+    sendControl('Q', 0, 0, 0, 0);
+}
+
+TEST_IFX(wifi_udp_multicast_sender, udp_sender_end) {
+    udpSender.stop();
+}
+
+TEST_IFX(wifi_udp_multicast_sender, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_multicast_sender, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_multicast_sender) {
+    RUN_TEST_CASE(wifi_udp_multicast_sender, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_udp_multicast_sender, udp_begin);
+    RUN_TEST_CASE(wifi_udp_multicast_sender, send_series);
+    RUN_TEST_CASE(wifi_udp_multicast_sender, udp_sender_end);
+    RUN_TEST_CASE(wifi_udp_multicast_sender, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_multicast_sender, wifi_end);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file test_wifi_udp_read_client.cpp
+ * @brief This test creates a WiFi (UDP) client which sends the datagrams evaluated by
+ * the read method comparison of the "test_wifi_udp_read_server.cpp" test.
+ *
+ * @details The tests runs the following sequence:
+ * - Connect to the access point created by the test_wifi_udp_read_server.cpp test
+ * - Starts WiFiUDP socket, listening at local port UDP_READ_PORT.
+ * - Sends the two greeting packets for the peekBuffer() contract test
+ * - Sends UDP_READ_PACKETS datagrams of UDP_READ_SIZE bytes for each read method
+ *   series, at UDP_READ_RATE_PPS so that the server is never overloaded
+ * - Sends the quit packets and stops the UDP client.
+ * - Disconnect the wifi connection and end the WiFi
+ *
+ * Byte 0 of a series datagram is the index of the series, byte i the value (uint8_t)i.
+ *
+ *  This test is paired with the "test_wifi_udp_read_server.cpp" test, which needs to be
+ *  executed in another board to receive and evaluate the datagrams.
+ *
+ * @note This test must be run after the "test_wifi_udp_read_server.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define UDP_READ_PORT               5005
+#define UDP_READ_SIZE               1024
+#define UDP_READ_PACKETS            200
+#define UDP_READ_RATE_PPS           100   // telemetry-like rate, the server must keep up
+#define UDP_READ_SERIES             3
+#define UDP_READ_CONTROL_REPEAT     3
+
+TEST_GROUP(wifi_udp_read_client);
+
+static TEST_SETUP(wifi_udp_read_client) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_read_client) {
+}
+
+WiFiUDP udpClient;
+
+static uint8_t packet[UDP_READ_SIZE];
+
+static bool sendPacket(const uint8_t *buf, size_t len) {
+    IPAddress ip(192, 168, 0, 1);
+
+    if (!udpClient.beginPacket(ip, UDP_READ_PORT)) {
+        return false;
+    }
+    if (udpClient.write(buf, len) != len) {
+        return false;
+    }
+    return udpClient.endPacket();
+}
+
+TEST_IFX(wifi_udp_read_client, wifi_connect_to_ap) {
+    int result = WiFi.begin("arduino-wifi-ap", "wifi-ap-password");
+    TEST_ASSERT_EQUAL_INT(WL_CONNECTED, result);
+}
+
+TEST_IFX(wifi_udp_read_client, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpClient.begin(UDP_READ_PORT));
+}
+
+TEST_IFX(wifi_udp_read_client, udp_send_greetings) {
+    const char *message1 = "Hello, UDP borrow 1!";
+    const char *message2 = "Hello, UDP borrow 2!";
+
+    TEST_ASSERT_TRUE(sendPacket((const uint8_t *)message1, strlen(message1)));
+    delay(100);
+    TEST_ASSERT_TRUE(sendPacket((const uint8_t *)message2, strlen(message2)));
+    delay(500); // Leave the server time for the contract test
+}
+
+TEST_IFX(wifi_udp_read_client, udp_send_series) {
+    const uint32_t intervalUs = MICROSECONDS_PER_SECOND / UDP_READ_RATE_PPS;
+
+    for (uint16_t i = 1; i < UDP_READ_SIZE; i++) {
+        packet[i] = (uint8_t)i;
+    }
+
+    for (uint8_t series = 0; series < UDP_READ_SERIES; series++) {
+        uint32_t sent = 0;
+        packet[0] = series;
+
+        uint32_t start = micros();
+        for (uint32_t i = 0; i < UDP_READ_PACKETS; i++) {
+            while ((micros() - start) < i * intervalUs) { }
+            if (sendPacket(packet, UDP_READ_SIZE)) {
+                sent++;
+            }
+        }
+        TEST_ASSERT_GREATER_THAN_UINT32(0, sent);
+    }
+
+    const uint8_t quit = 'Q';
+    for (uint8_t i = 0; i < UDP_READ_CONTROL_REPEAT; i++) {
+        delay(100);
+        sendPacket(&quit, 1);
+    }
+}
+
+TEST_IFX(wifi_udp_read_client, udp_client_end) {
+    udpClient.stop();
+}
+
+TEST_IFX(wifi_udp_read_client, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_read_client, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_read_client) {
+    RUN_TEST_CASE(wifi_udp_read_client, wifi_connect_to_ap);
+    RUN_TEST_CASE(wifi_udp_read_client, udp_begin);
+    RUN_TEST_CASE(wifi_udp_read_client, udp_send_greetings);
+    RUN_TEST_CASE(wifi_udp_read_client, udp_send_series);
+    RUN_TEST_CASE(wifi_udp_read_client, udp_client_end);
+    RUN_TEST_CASE(wifi_udp_read_client, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_read_client, wifi_end);
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_wifi_udp_read_server.cpp
+ * @brief This test creates a WiFi (UDP) server which pins down the contract of the
+ * borrow-style packet access and compares the CPU time per packet of the WiFiUDP
+ * read methods.
+ *
+ * @details The tests runs the following sequence:
+ * - Creates an WiFi access point to which the client connects
+ * - Starts WiFiUDP socket, listening at local port UDP_READ_PORT.
+ * - Verifies the peekBuffer() contract with the two greeting packets of the client
+ * - Receives the datagram series of the client, consuming every series with
+ *   another read method:
+ *   - series 0: byte-wise read()
+ *   - series 1: bulk read(buf, n)
+ *   - series 2: borrowed packet buffer, peekBuffer()
+ * - Reports the CPU time per packet of every read method
+ * - Stops the UDP server
+ * - Disconnect from the client and stop the access point.
+ *
+ * The borrow-style access is a proposed extension of WiFiUDP, available when the core
+ * defines ARDUINO_WIFIUDP_PEEK_BUFFER:
+ *
+ *   const uint8_t *peekBuffer(size_t &length);
+ *
+ * - It returns a pointer to the unread part of the current packet and sets length to
+ *   available(). Without unread data it returns nullptr and sets length to 0.
+ * - It does not consume data: available(), peek() and read() are not affected.
+ * - The pointer remains valid until the next parsePacket(), flush() or stop().
+ *
+ * This test is paired with the "test_wifi_udp_read_client.cpp" test, which needs to be
+ * executed in another board to send the datagrams.
+ *
+ * @note This test must be run before the "test_wifi_udp_read_client.cpp" test.
+ */
+
+#include "test_common_includes.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define UDP_READ_PORT               5005
+#define UDP_READ_MAX_SIZE           1472
+#define UDP_READ_IDLE_TIMEOUT_MS    60000
+
+typedef enum {
+    READ_BYTEWISE = 0,
+    READ_BULK,
+    READ_BORROW,
+    READ_METHODS
+} read_method_t;
+
+static const char *readMethodNames[READ_METHODS] = {"read()", "read(buf, n)", "peekBuffer()"};
+
+TEST_GROUP(wifi_udp_read_server);
+
+static TEST_SETUP(wifi_udp_read_server) {
+}
+
+static TEST_TEAR_DOWN(wifi_udp_read_server) {
+}
+
+WiFiUDP udpServer;
+
+static uint8_t packet[UDP_READ_MAX_SIZE];
+static RunningStats readTimeUs[READ_METHODS];
+static uint32_t checksumErrors[READ_METHODS];
+
+/* Expected payload checksum, the client sends byte i as (uint8_t)i */
+static uint32_t expectedChecksum(int size) {
+    uint32_t sum = 0;
+    for (int i = 1; i < size; i++) {
+        sum += (uint8_t)i;
+    }
+    return sum;
+}
+
+/**
+ * @brief Consume the current packet, without its series byte, with the given read method.
+ *
+ * @return Sum of the consumed payload bytes.
+ */
+static uint32_t consumePacket(read_method_t method, int size) {
+    uint32_t sum = 0;
+
+    switch (method) {
+        case READ_BYTEWISE:
+            for (int i = 0; i < size; i++) {
+                sum += (uint8_t)udpServer.read();
+            }
+            break;
+
+        case READ_BULK: {
+            int read_bytes = udpServer.read(packet, size);
+            for (int i = 0; i < read_bytes; i++) {
+                sum += packet[i];
+            }
+            break;
+        }
+
+        case READ_BORROW:
+        default: {
+#ifdef ARDUINO_WIFIUDP_PEEK_BUFFER
+            size_t length = 0;
+            const uint8_t *data = udpServer.peekBuffer(length);
+            for (size_t i = 0; i < length; i++) {
+                sum += data[i];
+            }
+#endif
+            break;
+        }
+    }
+    return sum;
+}
+
+TEST_IFX(wifi_udp_read_server, begin_ap) {
+    int result = WiFi.beginAP("arduino-wifi-ap", "wifi-ap-password", 1);
+    TEST_ASSERT_EQUAL_INT(WL_AP_LISTENING, result);
+}
+
+TEST_IFX(wifi_udp_read_server, udp_begin) {
+    TEST_ASSERT_EQUAL_INT(SOCKET_STATUS_BOUND, udpServer.begin(UDP_READ_PORT));
+}
+
+TEST_IFX(wifi_udp_read_server, peek_buffer_contract) {
+    const char *expectedMessage1 = "Hello, UDP borrow 1!";
+    const char *expectedMessage2 = "Hello, UDP borrow 2!";
+    int packetSize = 0;
+
+    /* The greetings are always consumed, so the series
+    below start in the same state with or without support */
+    while ((packetSize = udpServer.parsePacket()) != (int)strlen(expectedMessage1)) {}
+
+#ifdef ARDUINO_WIFIUDP_PEEK_BUFFER
+    size_t length = 0;
+    const uint8_t *data = udpServer.peekBuffer(length);
+
+    // The whole packet is borrowed, nothing is consumed
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL_INT(packetSize, length);
+    TEST_ASSERT_EQUAL_MEMORY(expectedMessage1, data, length);
+    TEST_ASSERT_EQUAL_INT(packetSize, udpServer.available());
+    TEST_ASSERT_EQUAL_CHAR('H', udpServer.peek());
+
+    // The borrowed buffer follows the read position
+    TEST_ASSERT_EQUAL_INT(7, udpServer.read(packet, 7));
+    data = udpServer.peekBuffer(length);
+    TEST_ASSERT_EQUAL_INT(packetSize - 7, length);
+    TEST_ASSERT_EQUAL_MEMORY(expectedMessage1 + 7, data, length);
+
+    // The next packet releases the borrowed buffer of the previous one
+    while ((packetSize = udpServer.parsePacket()) != (int)strlen(expectedMessage2)) {}
+    data = udpServer.peekBuffer(length);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL_INT(packetSize, length);
+    TEST_ASSERT_EQUAL_MEMORY(expectedMessage2, data, length);
+
+    // Without unread data nothing is borrowed
+    udpServer.flush();
+    data = udpServer.peekBuffer(length);
+    TEST_ASSERT_NULL(data);
+    TEST_ASSERT_EQUAL_INT(0, length);
+#else
+    while ((packetSize = udpServer.parsePacket()) != (int)strlen(expectedMessage2)) {}
+    udpServer.flush();
+    TEST_IGNORE_MESSAGE("peekBuffer() not supported by the core (ARDUINO_WIFIUDP_PEEK_BUFFER)");
+#endif
+}
+
+TEST_IFX(wifi_udp_read_server, udp_read_series) {
+    uint32_t lastPacket = millis();
+    bool quit = false;
+
+    while (!quit) {
+        TEST_ASSERT_TRUE_MESSAGE((millis() - lastPacket) < UDP_READ_IDLE_TIMEOUT_MS, "No datagram from client");
+
+        int packetSize = udpServer.parsePacket();
+        if (packetSize <= 0) {
+            continue;
+        }
+        lastPacket = millis();
+
+        int series = udpServer.peek();
+        if (series == 'Q') {
+            quit = true;
+            continue;
+        }
+        if (series < 0 || series >= READ_METHODS) {
+            udpServer.flush();
+            continue;
+        }
+
+        /* The series byte is skipped alike for all methods */
+        udpServer.read();
+        uint32_t start = micros();
+        uint32_t sum = consumePacket((read_method_t)series, packetSize - 1);
+        uint32_t elapsed = micros() - start;
+
+        readTimeUs[series].add(elapsed);
+        if (sum != expectedChecksum(packetSize)) {
+            checksumErrors[series]++;
+        }
+    }
+}
+
+TEST_IFX(wifi_udp_read_server, udp_report_read_methods) {
+    Serial.println();
+    for (uint8_t i = 0; i < READ_METHODS; i++) {
+#ifndef ARDUINO_WIFIUDP_PEEK_BUFFER
+        if (i == READ_BORROW) {
+            Serial.println("peekBuffer() : not supported by the core");
+            continue;
+        }
+#endif
+        readTimeUs[i].print(readMethodNames[i], "us per packet");
+        TEST_ASSERT_GREATER_THAN_UINT32(0, readTimeUs[i].count());
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, checksumErrors[i], "Payload differs from the sent data");
+    }
+}
+
+TEST_IFX(wifi_udp_read_server, udp_server_end) {
+    udpServer.stop();
+}
+
+TEST_IFX(wifi_udp_read_server, wifi_disconnect) {
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_STA_DISCONNECTED, WiFi.status());
+}
+
+TEST_IFX(wifi_udp_read_server, wifi_end) {
+    WiFi.end();
+    TEST_ASSERT_EQUAL_INT(WIFI_STATUS_UNINITED, WiFi.status());
+}
+
+TEST_GROUP_RUNNER(wifi_udp_read_server) {
+    RUN_TEST_CASE(wifi_udp_read_server, begin_ap);
+    RUN_TEST_CASE(wifi_udp_read_server, udp_begin);
+    RUN_TEST_CASE(wifi_udp_read_server, peek_buffer_contract);
+    RUN_TEST_CASE(wifi_udp_read_server, udp_read_series);
+    RUN_TEST_CASE(wifi_udp_read_server, udp_report_read_methods);
+    RUN_TEST_CASE(wifi_udp_read_server, udp_server_end);
+    RUN_TEST_CASE(wifi_udp_read_server, wifi_disconnect);
+    RUN_TEST_CASE(wifi_udp_read_server, wifi_end);
+}
@@ -0,0 +1,202 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/**
+ * @brief Host stand-in for the subset of the Arduino core API used by the test groups.
+ *
+ * @details This header replaces the board core's Arduino.h when the tests are built
+ * with the "host_test_<test_name>" make targets. It provides time, serial and
+ * interrupt locking services on top of the C++ standard library, and the analog I/O
+ * of a simulated analog front end (host_analog.cpp), so that test groups
+ * backed by a host stand-in (e.g. CAN.h) can run as plain Linux processes.
+ *
+ * Peripheral stand-ins emulate interrupt service routines with background threads.
+ * noInterrupts() / interrupts() therefore lock and unlock a process wide mutex which
+ * the stand-ins also hold while invoking user callbacks.
+ */
+
+// std includes
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO_ARCH_HOST
+    #define ARDUINO_ARCH_HOST
+#endif
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+typedef enum {
+    LOW     = 0,
+    HIGH    = 1,
+    CHANGE  = 2,
+    FALLING = 3,
+    RISING  = 4,
+} PinStatus;
+
+typedef enum {
+    INPUT            = 0x0,
+    OUTPUT           = 0x1,
+    INPUT_PULLUP     = 0x2,
+    INPUT_PULLDOWN   = 0x3,
+    OUTPUT_OPENDRAIN = 0x4,
+} PinMode;
+
+// time
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+// interrupts
+void noInterrupts(void);
+void interrupts(void);
+
+/**
+ * @brief Lock and unlock used by the peripheral stand-ins around emulated ISRs.
+ */
+void hostInterruptEnter(void);
+void hostInterruptExit(void);
+
+/**
+ * @brief Pins of the simulated analog front end, see host_analog.cpp.
+ */
+#define HOST_PIN_ANALOG_VDDA        14 // tied to VDDA
+#define HOST_PIN_ANALOG_DIVIDER     15 // mid-point of a voltage divider
+#define HOST_PIN_ANALOG_GND         16 // tied to ground
+#define HOST_PIN_DAC                17 // DAC output
+#define HOST_PIN_DAC_INPUT          18 // analog input wired to the DAC output
+
+typedef enum {
+    DEFAULT = 0,
+} AnalogReference;
+
+// digital and analog I/O
+void pinMode(uint8_t pin, uint8_t mode);
+void analogReference(uint8_t mode);
+void analogReadResolution(int bits);
+int analogRead(uint8_t pin);
+void analogWriteResolution(int bits);
+void analogWrite(uint8_t pin, int value);
+
+/**
+ * @brief Minimal string class providing what the test helpers require.
+ */
+class String {
+public:
+    String(const char *cstr = "");
+    String(const String &other);
+    ~String();
+
+    String &operator=(const String &other);
+
+    const char *c_str() const { return buffer; }
+    unsigned int length() const { return len; }
+    int indexOf(const char *str) const;
+
+private:
+    void assign(const char *cstr, size_t length);
+
+    char *buffer;
+    size_t len;
+};
+
+/**
+ * @brief IPv4 address, stored in network byte order like the core's IPAddress.
+ */
+class IPAddress {
+public:
+    IPAddress() : IPAddress(0, 0, 0, 0) {}
+    IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth);
+    explicit IPAddress(uint32_t address);
+
+    operator uint32_t() const;
+    bool operator==(const IPAddress &other) const { return memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+    bool operator!=(const IPAddress &other) const { return !(*this == other); }
+    uint8_t operator[](int index) const { return bytes[index]; }
+    uint8_t &operator[](int index) { return bytes[index]; }
+
+    String toString() const;
+
+private:
+    uint8_t bytes[4];
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    virtual void flush() {}
+
+    size_t print(const char *str) { return write(str); }
+    size_t print(const String &str) { return write(str.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(long long value, int base = DEC);
+    size_t print(unsigned long long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println(void) { return write("\r\n"); }
+    template <typename T> size_t println(T value) {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T> size_t println(T value, int format) {
+        size_t n = print(value, format);
+        return n + println();
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief Serial port mapped onto the process' stdin and stdout.
+ */
+class HostSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    String readString();
+
+    operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+// sketch entry points
+void setup(void);
+void loop(void);
+
+#endif // ARDUINO_H
@@ -0,0 +1,224 @@
+#ifndef CAN_H
+#define CAN_H
+
+/**
+ * @brief Host stand-in for the XMC CAN library (CANXMC).
+ *
+ * @details All CANXMC instances of a process are nodes of one virtual bus (hostCanBus).
+ * Frames queued by endPacket() or injected with HostCanBus::inject() take part in an
+ * arbitration round in which the lowest arbitration field wins, exactly as on a real
+ * bus: a standard data frame beats an extended frame with the same base identifier
+ * and a data frame beats a remote frame with the same identifier. Every transmitted
+ * frame advances a virtual bus clock by its nominal (unstuffed) bit length at the
+ * configured baud rate, so bus-load scenarios are reproducible without hardware.
+ *
+ * Acceptance filtering follows the receive message object: a frame is accepted when
+ * (id & can_id_mask) == (can_id & can_id_mask) and, if can_ide_mask is set, the frame
+ * type matches can_id_mode.
+ *
+ * On Linux, setting the environment variable HOST_CAN_INTERFACE (e.g. "vcan0") before
+ * begin() bridges the virtual bus to a SocketCAN interface. Frames won on the virtual
+ * bus are sent to the interface, and frames read from the interface are delivered from
+ * a background thread emulating the receive interrupt. Two test processes attached to
+ * the same vcan interface thus behave like two connected boards.
+ */
+
+// std includes
+#include <stdint.h>
+
+// Arduino includes
+#include <Arduino.h>
+
+#define CAN_DEFAULT_BAUDRATE     500000
+#define CAN_STANDARD_ID_MASK     0x7FFU
+#define CAN_EXTENDED_ID_MASK     0x1FFFFFFFU
+#define CAN_MAX_DATA_LENGTH      8U
+
+typedef enum {
+    XMC_CAN_FRAME_TYPE_STANDARD_11BITS = 0U,
+    XMC_CAN_FRAME_TYPE_EXTENDED_29BITS = 1U,
+} XMC_CAN_FRAME_TYPE_t;
+
+typedef enum {
+    XMC_CAN_ARBITRATION_MODE_ORDER_BASED_PRIO_1  = 1U,
+    XMC_CAN_ARBITRATION_MODE_IDE_DIR_BASED_PRIO_2 = 2U,
+    XMC_CAN_ARBITRATION_MODE_ORDER_BASED_PRIO_3  = 3U,
+} XMC_CAN_ARBITRATION_MODE_t;
+
+typedef enum {
+    XMC_CAN_MO_TYPE_RECMSGOBJ   = 0U,
+    XMC_CAN_MO_TYPE_TRANSMSGOBJ = 1U,
+} XMC_CAN_MO_TYPE_t;
+
+/**
+ * @brief Reduced XMC message object holding the fields evaluated by the tests.
+ */
+typedef struct {
+    uint32_t can_id;
+    uint32_t can_id_mask;
+    uint32_t can_id_mode;
+    uint32_t can_ide_mask;
+    uint32_t can_priority;
+    uint32_t can_mo_type;
+    uint8_t can_data_length;
+    uint8_t can_data[CAN_MAX_DATA_LENGTH];
+} XMC_CAN_MO_t;
+
+/**
+ * @brief A frame as seen on the virtual bus.
+ */
+typedef struct {
+    uint32_t id;
+    bool extended;
+    bool rtr;
+    uint8_t dlc;
+    uint8_t data[CAN_MAX_DATA_LENGTH];
+} HostCanFrame;
+
+/**
+ * @brief Counters of the virtual bus, e.g. to evaluate injected bus-load scenarios.
+ */
+typedef struct {
+    uint32_t frames;          // frames transmitted on the bus
+    uint32_t arbitrationLost; // arbitration rounds lost by a pending frame
+    uint32_t rejected;        // frame deliveries dropped by acceptance filters
+    uint64_t bits;            // nominal bits transmitted
+} HostCanStats;
+
+class CANXMC;
+
+class HostCanBus {
+public:
+    /**
+     * @brief Queue a frame sent by a simulated foreign node. It arbitrates against
+     *        every other pending frame at the next bus cycle.
+     */
+    void inject(const HostCanFrame &frame);
+
+    /**
+     * @brief Run arbitration rounds until no frame is pending.
+     */
+    void process();
+
+    /**
+     * @brief Virtual time in microseconds the bus has been busy transmitting.
+     */
+    uint64_t busTimeUs() const;
+
+    const HostCanStats &stats() const { return counters; }
+    void resetStats();
+
+    // used by CANXMC
+    void attach(CANXMC *node);
+    void detach(CANXMC *node);
+    bool submit(CANXMC *sender, const HostCanFrame &frame);
+    void deliver(CANXMC *sender, const HostCanFrame &frame);
+
+    static uint32_t arbitrationField(const HostCanFrame &frame);
+    static uint32_t frameBits(const HostCanFrame &frame);
+
+private:
+    static const uint8_t maxNodes = 8;
+    static const uint8_t maxPending = 32;
+
+    struct Pending {
+        CANXMC *sender; // nullptr for injected frames
+        HostCanFrame frame;
+    };
+
+    CANXMC *nodes[maxNodes] = {nullptr};
+    Pending pending[maxPending];
+    uint8_t pendingCount = 0;
+    HostCanStats counters = {0, 0, 0, 0};
+    uint64_t busTimeNs = 0;
+};
+
+extern HostCanBus hostCanBus;
+
+class CANXMC : public Stream {
+public:
+    CANXMC();
+    virtual ~CANXMC();
+
+    int begin(long baudRate = CAN_DEFAULT_BAUDRATE);
+    void end();
+
+    int beginPacket(int id, int dlc = -1, bool rtr = false);
+    int beginExtendedPacket(long id, int dlc = -1, bool rtr = false);
+    int endPacket();
+
+    int parsePacket();
+    long packetId();
+    bool packetExtended();
+    bool packetRtr();
+    int packetDlc();
+
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override {}
+
+    void onReceive(void (*callback)(int));
+
+    int filter(int id, int mask = CAN_STANDARD_ID_MASK);
+    int filterExtended(long id, long mask = CAN_EXTENDED_ID_MASK);
+
+    int observe();
+    int loopback();
+    int sleep();
+    int wakeup();
+
+    XMC_CAN_MO_t *getTxMessage() { return &txMessage; }
+    XMC_CAN_MO_t *getRxMessage() { return &rxMessage; }
+
+    long baudRate() const { return baud; }
+
+    // used by HostCanBus
+    bool accepts(const HostCanFrame &frame) const;
+    void receive(const HostCanFrame &frame);
+    bool receivesOwnFrames() const { return loopbackMode; }
+
+private:
+    static const uint8_t rxQueueSize = 16;
+
+    int startPacket(long id, bool extended, int dlc, bool rtr);
+    void bridgeOpen();
+    void bridgeClose();
+    void bridgeSend(const HostCanFrame &frame);
+    void bridgeReceiveTask();
+
+    XMC_CAN_MO_t txMessage;
+    XMC_CAN_MO_t rxMessage;
+
+    bool started;
+    bool loopbackMode;
+    long baud;
+
+    // frame under construction
+    bool txPending;
+    int txDlc;
+    HostCanFrame txFrame;
+
+    // frame being read
+    HostCanFrame rxFrame;
+    bool rxValid;
+    uint8_t rxIndex;
+
+    // received frames not yet parsed when no callback is registered
+    HostCanFrame rxQueue[rxQueueSize];
+    uint8_t rxHead;
+    uint8_t rxCount;
+
+    void (*onReceiveCallback)(int);
+
+    // SocketCAN bridge
+    int bridgeSocket;
+    void *bridgeThread;
+    volatile bool bridgeRunning;
+};
+
+#endif // CAN_H
@@ -0,0 +1,207 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+/**
+ * @brief Host stand-in for the WiFi library, mapping the virtual wireless network
+ * onto the Linux loopback interface.
+ *
+ * @details Every IPv4 address a.b.c.d of the virtual network is mapped to the loopback
+ * address 127.b.c.d, which Linux routes to the local host without any configuration.
+ * WiFiClient, WiFiServer and WiFiUDP are backed by real TCP/UDP sockets bound to the
+ * loopback address of the local IP, so two test processes behave like two boards of
+ * the same wireless network (e.g. test_wifi_server and test_wifi_client). Multicast
+ * groups are joined on the loopback interface. Ports below 1024 are shifted by
+ * HOST_WIFI_PRIVILEGED_PORT_OFFSET, as they cannot be bound without privileges;
+ * the ports reported to the test are the virtual ones.
+ *
+ * Access points and stations register in the directory given by the environment
+ * variable HOST_WIFI_DIR (default "/tmp/host_wifi"):
+ * - beginAP() creates "<dir>/<ssid>/ap" holding the process id, channel, password and
+ *   IP address of the access point. scanNetworks() lists the access points found there.
+ * - begin() waits for the access point until the timeout and checks the password.
+ *   With DHCP the station takes the lowest free address above the access point
+ *   address. The lease "<dir>/<ssid>/sta_<ip>" holds the process id of the station,
+ *   and leases of dead processes are free again.
+ * - connected() of an access point counts the leases of its SSID. disconnect() of a
+ *   station keeps its lease for HOST_WIFI_DEAUTH_MS, as the deauthentication of a
+ *   real station does, so that access points polling connected() see short-lived stations.
+ *
+ * The stand-in also implements the proposed extensions of the WiFi library evaluated
+ * by the test groups, and defines their feature macros.
+ */
+
+// std includes
+#include <stdint.h>
+
+// Arduino includes
+#include <Arduino.h>
+
+#define ARDUINO_WIFI_ASYNC_SCAN
+#define ARDUINO_WIFI_ASYNC_API
+
+#define HOST_WIFI_DEFAULT_DIR               "/tmp/host_wifi"
+#define HOST_WIFI_PRIVILEGED_PORT_OFFSET    10000
+#define HOST_WIFI_DEFAULT_TIMEOUT_MS        10000
+#define HOST_WIFI_SCAN_MS                   100
+#define HOST_WIFI_DEAUTH_MS                 20
+#define HOST_WIFI_MAX_SCAN_RESULTS          16
+#define HOST_WIFI_SSID_MAX_LENGTH           32
+#define HOST_WIFI_PASSPHRASE_MAX_LENGTH     64
+
+#define WIFI_SCAN_RUNNING   (-1)
+#define WIFI_SCAN_FAILED    (-2)
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL,
+    WL_SCAN_COMPLETED,
+    WL_CONNECTED,
+    WL_CONNECT_FAILED,
+    WL_CONNECTION_LOST,
+    WL_DISCONNECTED,
+    WL_AP_LISTENING,
+    WL_AP_CONNECTED,
+    WL_AP_FAILED,
+    WIFI_STATUS_UNINITED,
+    WIFI_STATUS_STA_DISCONNECTED,
+    /* The test groups expect either value after disconnect() of an access
+    point. The stand-in does not distinguish them. */
+    WIFI_STATUS_AP_DISCONNECTED = WIFI_STATUS_STA_DISCONNECTED,
+} wifi_status_t;
+
+typedef enum {
+    WIFI_ERROR_NONE = 0,
+    WIFI_ERROR_STA_CONNECT_FAILED,
+    WIFI_ERROR_AP_CONNECT_FAILED,
+    WIFI_ERROR_PING_FAILED,
+    WIFI_ERROR_DNS_FAILED,
+} wifi_error_t;
+
+typedef enum {
+    AUTH_MODE_OPEN = 0,
+    AUTH_MODE_WEP,
+    AUTH_MODE_WPA,
+    AUTH_MODE_WPA2,
+    AUTH_MODE_WPA3,
+} wifi_auth_mode_t;
+
+typedef enum {
+    SOCKET_STATUS_UNINITED = 0,
+    SOCKET_STATUS_CREATED,
+    SOCKET_STATUS_BOUND,
+    SOCKET_STATUS_LISTENING,
+    SOCKET_STATUS_CONNECTED,
+    SOCKET_STATUS_DELETED,
+} socket_status_t;
+
+/**
+ * @brief Mapping between the virtual network and the loopback sockets.
+ *
+ * @details Addresses and ports are in host byte order. Multicast addresses are
+ * not mapped.
+ */
+uint32_t hostWifiToLoopback(const IPAddress &ip);
+IPAddress hostWifiFromLoopback(uint32_t address);
+uint16_t hostWifiToLoopbackPort(uint16_t port);
+uint16_t hostWifiFromLoopbackPort(uint16_t port);
+
+class WiFiClass {
+public:
+    WiFiClass();
+
+    int begin(const char *ssid, const char *passphrase = nullptr);
+    int beginAsync(const char *ssid, const char *passphrase = nullptr);
+    int beginAP(const char *ssid, const char *passphrase = nullptr, uint8_t channel = 1);
+    void config(IPAddress local_ip);
+    void config(IPAddress local_ip, IPAddress dns_server);
+    void config(IPAddress local_ip, IPAddress dns_server, IPAddress gateway);
+    void config(IPAddress local_ip, IPAddress dns_server, IPAddress gateway, IPAddress subnet);
+    void setDNS(IPAddress dns_server1);
+    void setDNS(IPAddress dns_server1, IPAddress dns_server2);
+    void setTimeout(uint32_t timeout_ms) { timeoutMs = timeout_ms; }
+    void disconnect();
+    void end();
+
+    uint8_t status();
+    uint8_t reasonCode() const { return reason; }
+    uint8_t connected();
+
+    int8_t scanNetworks();
+    int8_t scanNetworks(bool async);
+    int8_t scanComplete();
+    void scanDelete();
+
+    const char *SSID();
+    const char *SSID(uint8_t index);
+    uint8_t *BSSID(uint8_t *bssid);
+    uint8_t *BSSID(uint8_t index, uint8_t *bssid);
+    int32_t RSSI();
+    int32_t RSSI(uint8_t index);
+    uint8_t encryptionType();
+    uint8_t encryptionType(uint8_t index);
+    int32_t channel();
+    int32_t channel(uint8_t index);
+
+    uint8_t *macAddress(uint8_t *mac);
+    IPAddress localIP() { return localAddress; }
+    IPAddress subnetMask() { return subnetAddress; }
+    IPAddress gatewayIP() { return gatewayAddress; }
+    IPAddress dnsIP(int index = 0) { return dnsAddress[index == 0 ? 0 : 1]; }
+
+    int hostByName(const char *hostname, IPAddress &result);
+    int ping(const char *hostname, uint8_t ttl = 128);
+    int ping(IPAddress host, uint8_t ttl = 128);
+
+private:
+    typedef enum {
+        MODE_NONE = 0,
+        MODE_STA,
+        MODE_AP,
+    } wifi_mode_t;
+
+    typedef struct {
+        char ssid[HOST_WIFI_SSID_MAX_LENGTH + 1];
+        uint8_t bssid[6];
+        int32_t channel;
+    } scan_result_t;
+
+    bool tryJoin();
+    void leave();
+    void applyConfig(const IPAddress &default_ip, const IPAddress &default_gateway);
+    void scanInto(scan_result_t *results, int8_t &count);
+    const scan_result_t *scanResult(uint8_t index);
+
+    wifi_mode_t mode;
+    uint8_t wifiStatus;
+    uint8_t reason;
+    uint32_t timeoutMs;
+
+    char currentSsid[HOST_WIFI_SSID_MAX_LENGTH + 1];
+    char currentPassphrase[HOST_WIFI_PASSPHRASE_MAX_LENGTH + 1];
+    uint8_t currentBssid[6];
+    int32_t currentChannel;
+    char leasePath[256];
+
+    /* beginAsync() completes while status() is polled */
+    bool joining;
+    uint32_t joinStart;
+
+    bool staticConfig;
+    IPAddress staticLocal;
+    IPAddress staticGateway;
+    IPAddress staticSubnet;
+    IPAddress staticDns;
+
+    IPAddress localAddress;
+    IPAddress subnetAddress;
+    IPAddress gatewayAddress;
+    IPAddress dnsAddress[2];
+
+    /* Shared with the thread of an asynchronous scan */
+    scan_result_t scanResults[HOST_WIFI_MAX_SCAN_RESULTS];
+    volatile int8_t scanCount;
+};
+
+extern WiFiClass WiFi;
+
+#endif // WIFI_H
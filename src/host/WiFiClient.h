@@ -0,0 +1,72 @@
+#ifndef WIFICLIENT_H
+#define WIFICLIENT_H
+
+/**
+ * @brief Host stand-in for the WiFi TCP client, backed by a loopback TCP socket.
+ *
+ * @details Copies of a client share the same connection, as the clients returned by
+ * WiFiServer::available() share the connection with the server. The connection is
+ * closed by stop() or when the peer closes it, not by the destructor.
+ *
+ * Clients accepted by a server report the server port as remotePort(), like the core.
+ *
+ * The proposed asynchronous API (ARDUINO_WIFI_ASYNC_API) is provided by connectAsync()
+ * and onReceive(). The receive callbacks are invoked from a background thread emulating
+ * the network stack, with the interrupt lock of the host Arduino.h held.
+ *
+ * The proposed no-delay switch (ARDUINO_WIFICLIENT_NODELAY) maps to TCP_NODELAY.
+ * By default small writes are coalesced, as by the lwIP stack of the cores.
+ */
+
+// std includes
+#include <memory>
+#include <stdint.h>
+
+// Arduino includes
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define ARDUINO_WIFICLIENT_NODELAY
+
+class WiFiServer;
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient();
+
+    int connect(IPAddress ip, uint16_t port);
+    int connect(const char *host, uint16_t port);
+    int connectAsync(IPAddress ip, uint16_t port);
+    void onReceive(void (*callback)(void *arg), void *arg);
+    void setNoDelay(bool nodelay);
+    bool getNoDelay();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size);
+    int peek() override;
+    void flush() override;
+    void stop();
+
+    uint8_t connected();
+    uint8_t status();
+    IPAddress remoteIP();
+    uint16_t remotePort();
+
+    operator bool() { return connected() != 0; }
+
+    struct Connection;
+
+private:
+    friend class WiFiServer;
+
+    explicit WiFiClient(const std::shared_ptr<Connection> &connection);
+
+    std::shared_ptr<Connection> conn;
+};
+
+#endif // WIFICLIENT_H
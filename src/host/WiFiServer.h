@@ -0,0 +1,52 @@
+#ifndef WIFISERVER_H
+#define WIFISERVER_H
+
+/**
+ * @brief Host stand-in for the WiFi TCP server, listening on the loopback address of
+ * the local IP.
+ *
+ * @details Pending connections are accepted whenever the server is polled. available()
+ * returns the accepted clients with unread data in turns, and the Print interface
+ * writes to all connected clients.
+ */
+
+// std includes
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+// Arduino includes
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+class WiFiServer : public Print {
+public:
+    WiFiServer() : WiFiServer(80) {}
+    explicit WiFiServer(uint16_t port);
+    ~WiFiServer();
+
+    void begin();
+    void begin(uint16_t port);
+    void end();
+
+    WiFiClient available();
+    uint8_t connectedSize();
+    uint8_t status() const { return serverStatus; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+private:
+    void acceptPending();
+    void prune();
+
+    uint16_t serverPort;
+    int fd;
+    uint8_t serverStatus;
+    size_t nextClient;
+    std::vector<std::shared_ptr<WiFiClient::Connection>> clients;
+};
+
+#endif // WIFISERVER_H
@@ -0,0 +1,74 @@
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+/**
+ * @brief Host stand-in for the WiFi UDP socket, bound to the loopback address of the
+ * local IP.
+ *
+ * @details A multicast socket also binds the group address on the loopback interface
+ * and receives from both sockets. parsePacket() reads one datagram into the receive
+ * buffer, which is also exposed without a copy by the proposed peekBuffer()
+ * (ARDUINO_WIFIUDP_PEEK_BUFFER).
+ */
+
+// std includes
+#include <stdint.h>
+
+// Arduino includes
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define ARDUINO_WIFIUDP_PEEK_BUFFER
+
+#define HOST_WIFIUDP_MAX_PACKET_SIZE    1500
+
+class WiFiUDP : public Stream {
+public:
+    WiFiUDP();
+    ~WiFiUDP();
+
+    uint8_t begin(uint16_t port);
+    uint8_t beginMulticast(IPAddress ip, uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    int beginPacket(const char *host, uint16_t port);
+    int endPacket();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    int parsePacket();
+    int available() override;
+    int read() override;
+    int read(unsigned char *buffer, size_t len);
+    int read(char *buffer, size_t len) { return read((unsigned char *)buffer, len); }
+    int peek() override;
+    void flush() override;
+    const uint8_t *peekBuffer(size_t &length);
+
+    IPAddress remoteIP() { return remoteAddress; }
+    uint16_t remotePort() { return remotePortNumber; }
+
+private:
+    bool bindSocket(int &socket_fd, uint32_t address, uint16_t port);
+    int receive(int socket_fd);
+
+    int fd;
+    int multicastFd;
+    uint16_t localPort;
+    IPAddress boundIP;
+
+    IPAddress txAddress;
+    uint16_t txPort;
+    size_t txLength;
+    uint8_t txBuffer[HOST_WIFIUDP_MAX_PACKET_SIZE];
+
+    IPAddress remoteAddress;
+    uint16_t remotePortNumber;
+    size_t rxLength;
+    size_t rxPosition;
+    uint8_t rxBuffer[HOST_WIFIUDP_MAX_PACKET_SIZE];
+};
+
+#endif // WIFIUDP_H
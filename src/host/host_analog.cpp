@@ -0,0 +1,120 @@
+// std includes
+#include <random>
+
+// Arduino includes
+#include <Arduino.h>
+
+/**
+ * Host model of the analog front end of a board: a 12 bit ADC and a 12 bit DAC whose
+ * output is wired to the ADC input HOST_PIN_DAC_INPUT, as the DAC tests expect.
+ *
+ * The model is deterministic but not ideal, so that the measurements of the test
+ * groups have something to find:
+ * - The ADC adds gaussian noise of ADC_NOISE_LSB and every conversion takes
+ *   ADC_CONVERSION_US. The result is scaled to the resolution of analogReadResolution().
+ * - The DAC output spans DAC_MINIMUM_V to DAC_MAXIMUM_V (as the ANALOG_MINIMUM and
+ *   ANALOG_MAXIMUM of test_analogio_dac.cpp), with a bow of DAC_INL_BOW_LSB and a step
+ *   of DAC_MIDSCALE_STEP_LSB at the mid-scale code transition. The output settles
+ *   exponentially with the time constant DAC_SETTLE_TAU_US.
+ */
+
+#define VDDA_V                  3.3
+#define ADC_BITS                12
+#define ADC_NOISE_LSB           0.4
+#define ADC_CONVERSION_US       1
+#define DAC_BITS                12
+#define DAC_MINIMUM_V           0.3
+#define DAC_MAXIMUM_V           2.5
+#define DAC_INL_BOW_LSB         0.8
+#define DAC_MIDSCALE_STEP_LSB   0.5
+#define DAC_SETTLE_TAU_US       2.0
+
+static const int adc_max = (1 << ADC_BITS) - 1;
+static const int dac_max = (1 << DAC_BITS) - 1;
+
+static int read_resolution = 10;
+static int write_resolution = 8;
+
+static std::mt19937 noise_generator(0x41444321);
+static std::normal_distribution<double> noise(0.0, ADC_NOISE_LSB);
+
+// DAC output: exponential transition from dac_from_v to dac_to_v starting at dac_step_us
+static double dac_from_v = DAC_MINIMUM_V;
+static double dac_to_v = DAC_MINIMUM_V;
+static unsigned long dac_step_us = 0;
+
+/**
+ * @brief Scale a value between resolutions by shifting, as the cores do.
+ */
+static long rescale(long value, int from_bits, int to_bits) {
+    return to_bits >= from_bits ? value << (to_bits - from_bits) : value >> (from_bits - to_bits);
+}
+
+static double dac_output_v(unsigned long now_us) {
+    double elapsed = (double)(now_us - dac_step_us);
+    return dac_to_v + (dac_from_v - dac_to_v) * exp(-elapsed / DAC_SETTLE_TAU_US);
+}
+
+static double dac_code_v(int code) {
+    double lsb_v = (DAC_MAXIMUM_V - DAC_MINIMUM_V) / dac_max;
+    double x = 2.0 * code / dac_max - 1.0;
+    double error_lsb = DAC_INL_BOW_LSB * (1.0 - x * x) + (code > dac_max / 2 ? DAC_MIDSCALE_STEP_LSB : 0.0);
+    return DAC_MINIMUM_V + (code + error_lsb) * lsb_v;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void analogReference(uint8_t mode) { (void)mode; }
+
+void analogReadResolution(int bits) { read_resolution = bits; }
+
+int analogRead(uint8_t pin) {
+    unsigned long start = micros();
+    double input_v;
+
+    switch (pin) {
+    case HOST_PIN_ANALOG_VDDA:
+        input_v = VDDA_V;
+        break;
+    case HOST_PIN_ANALOG_DIVIDER:
+        input_v = VDDA_V / 2.0;
+        break;
+    case HOST_PIN_DAC_INPUT:
+        input_v = dac_output_v(start);
+        break;
+    default:
+        input_v = 0.0;
+        break;
+    }
+
+    long code = lround(input_v / VDDA_V * adc_max + noise(noise_generator));
+    if (code < 0) {
+        code = 0;
+    } else if (code > adc_max) {
+        code = adc_max;
+    }
+
+    while (micros() - start < ADC_CONVERSION_US) {
+    }
+    return (int)rescale(code, ADC_BITS, read_resolution);
+}
+
+void analogWriteResolution(int bits) { write_resolution = bits; }
+
+void analogWrite(uint8_t pin, int value) {
+    if (pin != HOST_PIN_DAC) {
+        return;
+    }
+    long code = rescale(value, write_resolution, DAC_BITS);
+    if (code > dac_max) {
+        code = dac_max;
+    }
+
+    unsigned long now = micros();
+    dac_from_v = dac_output_v(now);
+    dac_to_v = dac_code_v((int)code);
+    dac_step_us = now;
+}
@@ -0,0 +1,173 @@
+// std includes
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// Arduino includes
+#include <Arduino.h>
+
+/**
+ * Host implementation of the Arduino core services declared in the host Arduino.h.
+ */
+
+static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+// Emulated global interrupt lock, shared with the peripheral stand-in threads.
+static std::recursive_mutex interrupt_lock;
+static thread_local unsigned int interrupt_lock_depth = 0;
+
+HostSerial Serial;
+
+unsigned long millis(void) {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start_time)
+        .count();
+}
+
+unsigned long micros(void) {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start_time)
+        .count();
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void delayMicroseconds(unsigned int us) {
+    // Busy wait, as sleeping is far too coarse for microsecond delays
+    unsigned long start = micros();
+    while (micros() - start < us) {
+    }
+}
+
+void yield(void) { std::this_thread::yield(); }
+
+void noInterrupts(void) {
+    interrupt_lock.lock();
+    interrupt_lock_depth++;
+}
+
+void interrupts(void) {
+    // Tests may enable interrupts without disabling them first
+    if (interrupt_lock_depth > 0) {
+        interrupt_lock_depth--;
+        interrupt_lock.unlock();
+    }
+}
+
+void hostInterruptEnter(void) { interrupt_lock.lock(); }
+
+void hostInterruptExit(void) { interrupt_lock.unlock(); }
+
+String::String(const char *cstr) : buffer(nullptr), len(0) {
+    assign(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+}
+
+String::String(const String &other) : buffer(nullptr), len(0) { assign(other.buffer, other.len); }
+
+String::~String() { free(buffer); }
+
+String &String::operator=(const String &other) {
+    if (this != &other) {
+        assign(other.buffer, other.len);
+    }
+    return *this;
+}
+
+int String::indexOf(const char *str) const {
+    const char *found = strstr(buffer, str);
+    return found ? (int)(found - buffer) : -1;
+}
+
+void String::assign(const char *cstr, size_t length) {
+    char *copy = (char *)malloc(length + 1);
+    memcpy(copy, cstr, length);
+    copy[length] = '\0';
+    free(buffer);
+    buffer = copy;
+    len = length;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    if (value < 0 && base == DEC) {
+        size_t n = print('-');
+        return n + print((unsigned long long)(-(long long)value), base);
+    }
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) { return print((unsigned long long)value, base); }
+
+size_t Print::print(long long value, int base) {
+    if (value < 0 && base == DEC) {
+        size_t n = print('-');
+        return n + print((unsigned long long)(-value), base);
+    }
+    return print((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    char digits[66];
+    char *p = &digits[sizeof(digits) - 1];
+    *p = '\0';
+
+    if (base < 2) {
+        base = DEC;
+    }
+
+    do {
+        unsigned int digit = (unsigned int)(value % (unsigned int)base);
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= (unsigned int)base;
+    } while (value);
+
+    return write(p);
+}
+
+size_t Print::print(double value, int digits) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+size_t HostSerial::write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+
+size_t HostSerial::write(const uint8_t *buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+
+void HostSerial::flush() { fflush(stdout); }
+
+String HostSerial::readString() {
+    char line[256] = {0};
+    if (fgets(line, sizeof(line), stdin) == nullptr) {
+        return String("");
+    }
+    return String(line);
+}
+
+IPAddress::IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth) {
+    bytes[0] = first;
+    bytes[1] = second;
+    bytes[2] = third;
+    bytes[3] = fourth;
+}
+
+IPAddress::IPAddress(uint32_t address) { memcpy(bytes, &address, sizeof(bytes)); }
+
+IPAddress::operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, bytes, sizeof(address));
+    return address;
+}
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(text);
+}
@@ -0,0 +1,506 @@
+// std includes
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#if defined(__linux__)
+    #include <linux/can.h>
+    #include <linux/can/raw.h>
+    #include <net/if.h>
+    #include <poll.h>
+    #include <sys/ioctl.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+// Arduino includes
+#include <Arduino.h>
+#include <CAN.h>
+
+HostCanBus hostCanBus;
+CANXMC CAN;
+
+/**
+ * @brief Check whether a baud rate is one of the nominal CAN bit rates.
+ */
+static bool is_supported_baudrate(long baudRate) {
+    const long baudrates[] = {10000, 20000, 50000, 100000, 125000, 250000, 500000, 800000, 1000000};
+    for (size_t i = 0; i < sizeof(baudrates) / sizeof(baudrates[0]); i++) {
+        if (baudrates[i] == baudRate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HostCanBus::attach(CANXMC *node) {
+    for (uint8_t i = 0; i < maxNodes; i++) {
+        if (nodes[i] == node) {
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < maxNodes; i++) {
+        if (nodes[i] == nullptr) {
+            nodes[i] = node;
+            return;
+        }
+    }
+}
+
+void HostCanBus::detach(CANXMC *node) {
+    for (uint8_t i = 0; i < maxNodes; i++) {
+        if (nodes[i] == node) {
+            nodes[i] = nullptr;
+        }
+    }
+}
+
+void HostCanBus::inject(const HostCanFrame &frame) {
+    hostInterruptEnter();
+    if (pendingCount < maxPending) {
+        pending[pendingCount].sender = nullptr;
+        pending[pendingCount].frame = frame;
+        pendingCount++;
+    }
+    hostInterruptExit();
+}
+
+bool HostCanBus::submit(CANXMC *sender, const HostCanFrame &frame) {
+    bool queued = false;
+
+    hostInterruptEnter();
+    if (pendingCount < maxPending) {
+        pending[pendingCount].sender = sender;
+        pending[pendingCount].frame = frame;
+        pendingCount++;
+        queued = true;
+    }
+    hostInterruptExit();
+
+    if (queued) {
+        process();
+    }
+    return queued;
+}
+
+void HostCanBus::process() {
+    hostInterruptEnter();
+
+    while (pendingCount > 0) {
+        // Arbitration: the lowest arbitration field wins the bus
+        uint8_t winner = 0;
+        for (uint8_t i = 1; i < pendingCount; i++) {
+            if (arbitrationField(pending[i].frame) < arbitrationField(pending[winner].frame)) {
+                winner = i;
+            }
+        }
+        counters.arbitrationLost += pendingCount - 1;
+
+        Pending transmitted = pending[winner];
+        for (uint8_t i = winner; i + 1 < pendingCount; i++) {
+            pending[i] = pending[i + 1];
+        }
+        pendingCount--;
+
+        long baudRate = CAN_DEFAULT_BAUDRATE;
+        if (transmitted.sender != nullptr) {
+            baudRate = transmitted.sender->baudRate();
+        }
+        uint32_t bits = frameBits(transmitted.frame);
+        counters.frames++;
+        counters.bits += bits;
+        busTimeNs += (uint64_t)bits * 1000000000ULL / (uint64_t)baudRate;
+
+        deliver(transmitted.sender, transmitted.frame);
+    }
+
+    hostInterruptExit();
+}
+
+void HostCanBus::deliver(CANXMC *sender, const HostCanFrame &frame) {
+    for (uint8_t i = 0; i < maxNodes; i++) {
+        CANXMC *node = nodes[i];
+        if (node == nullptr || (node == sender && !node->receivesOwnFrames())) {
+            continue;
+        }
+        if (node->accepts(frame)) {
+            node->receive(frame);
+        } else {
+            counters.rejected++;
+        }
+    }
+}
+
+uint64_t HostCanBus::busTimeUs() const { return busTimeNs / 1000ULL; }
+
+void HostCanBus::resetStats() {
+    hostInterruptEnter();
+    memset(&counters, 0, sizeof(counters));
+    busTimeNs = 0;
+    hostInterruptExit();
+}
+
+/**
+ * @brief Arbitration field as transmitted on the bus, lower values win.
+ *
+ * Layout: base id (11) | RTR or SRR (1) | IDE (1) | extended id (18) | RTR (1).
+ * A standard frame ends after IDE, which is modelled by zero extension bits.
+ */
+uint32_t HostCanBus::arbitrationField(const HostCanFrame &frame) {
+    if (frame.extended) {
+        uint32_t base = (frame.id >> 18) & CAN_STANDARD_ID_MASK;
+        uint32_t extension = frame.id & 0x3FFFFU;
+        return (base << 21) | (1U << 20) | (1U << 19) | (extension << 1) | (frame.rtr ? 1U : 0U);
+    }
+    return ((frame.id & CAN_STANDARD_ID_MASK) << 21) | ((frame.rtr ? 1U : 0U) << 20);
+}
+
+/**
+ * @brief Nominal frame length in bits without stuff bits, including interframe space.
+ */
+uint32_t HostCanBus::frameBits(const HostCanFrame &frame) {
+    uint32_t data_bits = frame.rtr ? 0U : 8U * frame.dlc;
+    return (frame.extended ? 67U : 47U) + data_bits;
+}
+
+CANXMC::CANXMC()
+    : started(false), loopbackMode(false), baud(CAN_DEFAULT_BAUDRATE), txPending(false), txDlc(-1), rxValid(false),
+      rxIndex(0), rxHead(0), rxCount(0), onReceiveCallback(nullptr), bridgeSocket(-1), bridgeThread(nullptr),
+      bridgeRunning(false) {
+    memset(&txMessage, 0, sizeof(txMessage));
+    txMessage.can_id_mode = XMC_CAN_FRAME_TYPE_STANDARD_11BITS;
+    txMessage.can_priority = XMC_CAN_ARBITRATION_MODE_ORDER_BASED_PRIO_1;
+    txMessage.can_id_mask = 0x00000000U;
+    txMessage.can_ide_mask = 0U;
+    txMessage.can_mo_type = XMC_CAN_MO_TYPE_TRANSMSGOBJ;
+
+    memset(&rxMessage, 0, sizeof(rxMessage));
+    rxMessage.can_id_mode = XMC_CAN_FRAME_TYPE_STANDARD_11BITS;
+    rxMessage.can_priority = XMC_CAN_ARBITRATION_MODE_ORDER_BASED_PRIO_1;
+    rxMessage.can_id_mask = 0x00000000U;
+    rxMessage.can_ide_mask = 0U;
+    rxMessage.can_mo_type = XMC_CAN_MO_TYPE_RECMSGOBJ;
+
+    memset(&txFrame, 0, sizeof(txFrame));
+    memset(&rxFrame, 0, sizeof(rxFrame));
+}
+
+CANXMC::~CANXMC() { end(); }
+
+int CANXMC::begin(long baudRate) {
+    if (!is_supported_baudrate(baudRate)) {
+        return 0;
+    }
+
+    baud = baudRate;
+    started = true;
+    hostCanBus.attach(this);
+    bridgeOpen();
+    return 1;
+}
+
+void CANXMC::end() {
+    bridgeClose();
+    hostCanBus.detach(this);
+    started = false;
+    txPending = false;
+}
+
+int CANXMC::beginPacket(int id, int dlc, bool rtr) {
+    if (id < 0 || (uint32_t)id > CAN_STANDARD_ID_MASK) {
+        return 0;
+    }
+    return startPacket(id, false, dlc, rtr);
+}
+
+int CANXMC::beginExtendedPacket(long id, int dlc, bool rtr) {
+    if (id < 0 || (uint32_t)id > CAN_EXTENDED_ID_MASK) {
+        return 0;
+    }
+    return startPacket(id, true, dlc, rtr);
+}
+
+int CANXMC::startPacket(long id, bool extended, int dlc, bool rtr) {
+    if (dlc > (int)CAN_MAX_DATA_LENGTH) {
+        return 0;
+    }
+
+    memset(&txFrame, 0, sizeof(txFrame));
+    txFrame.id = (uint32_t)id;
+    txFrame.extended = extended;
+    txFrame.rtr = rtr;
+    txFrame.dlc = dlc < 0 ? 0 : (uint8_t)dlc;
+    txDlc = dlc;
+    txPending = true;
+
+    txMessage.can_id = txFrame.id;
+    txMessage.can_id_mode = extended ? XMC_CAN_FRAME_TYPE_EXTENDED_29BITS : XMC_CAN_FRAME_TYPE_STANDARD_11BITS;
+    txMessage.can_data_length = 0;
+    return 1;
+}
+
+int CANXMC::endPacket() {
+    if (!txPending) {
+        return 0;
+    }
+    txPending = false;
+
+    // Without an explicit dlc, data frames are as long as the data written
+    if (txDlc < 0) {
+        txFrame.dlc = txMessage.can_data_length;
+    }
+
+    if (!hostCanBus.submit(this, txFrame)) {
+        return 0;
+    }
+    bridgeSend(txFrame);
+    return 1;
+}
+
+size_t CANXMC::write(uint8_t byte) { return write(&byte, 1); }
+
+size_t CANXMC::write(const uint8_t *buffer, size_t size) {
+    if (!txPending || txFrame.rtr) {
+        return 0;
+    }
+
+    size_t free_bytes = CAN_MAX_DATA_LENGTH - txMessage.can_data_length;
+    if (size > free_bytes) {
+        size = free_bytes;
+    }
+    memcpy(&txMessage.can_data[txMessage.can_data_length], buffer, size);
+    memcpy(&txFrame.data[txMessage.can_data_length], buffer, size);
+    txMessage.can_data_length += (uint8_t)size;
+    return size;
+}
+
+bool CANXMC::accepts(const HostCanFrame &frame) const {
+    if (!started) {
+        return false;
+    }
+    if (rxMessage.can_ide_mask != 0U &&
+        frame.extended != (rxMessage.can_id_mode == XMC_CAN_FRAME_TYPE_EXTENDED_29BITS)) {
+        return false;
+    }
+    return ((frame.id ^ rxMessage.can_id) & rxMessage.can_id_mask) == 0U;
+}
+
+/**
+ * @brief Called with the interrupt lock held, i.e. in emulated ISR context.
+ */
+void CANXMC::receive(const HostCanFrame &frame) {
+    if (onReceiveCallback != nullptr) {
+        rxFrame = frame;
+        rxValid = true;
+        rxIndex = 0;
+        rxMessage.can_data_length = frame.dlc;
+        memcpy(rxMessage.can_data, frame.data, sizeof(frame.data));
+        onReceiveCallback(available());
+        return;
+    }
+
+    if (rxCount < rxQueueSize) {
+        rxQueue[(rxHead + rxCount) % rxQueueSize] = frame;
+        rxCount++;
+    }
+}
+
+int CANXMC::parsePacket() {
+    hostCanBus.process();
+
+    hostInterruptEnter();
+    if (rxCount == 0) {
+        rxValid = false;
+        hostInterruptExit();
+        return 0;
+    }
+    rxFrame = rxQueue[rxHead];
+    rxHead = (rxHead + 1) % rxQueueSize;
+    rxCount--;
+    rxValid = true;
+    rxIndex = 0;
+    rxMessage.can_data_length = rxFrame.dlc;
+    memcpy(rxMessage.can_data, rxFrame.data, sizeof(rxFrame.data));
+    hostInterruptExit();
+
+    return rxFrame.dlc;
+}
+
+long CANXMC::packetId() { return rxValid ? (long)rxFrame.id : -1; }
+
+bool CANXMC::packetExtended() { return rxValid && rxFrame.extended; }
+
+bool CANXMC::packetRtr() { return rxValid && rxFrame.rtr; }
+
+int CANXMC::packetDlc() { return rxValid ? rxFrame.dlc : -1; }
+
+int CANXMC::available() {
+    if (!rxValid || rxFrame.rtr) {
+        return 0;
+    }
+    return rxFrame.dlc - rxIndex;
+}
+
+int CANXMC::read() {
+    if (available() <= 0) {
+        return -1;
+    }
+    return rxFrame.data[rxIndex++];
+}
+
+int CANXMC::peek() {
+    if (available() <= 0) {
+        return -1;
+    }
+    return rxFrame.data[rxIndex];
+}
+
+void CANXMC::onReceive(void (*callback)(int)) { onReceiveCallback = callback; }
+
+int CANXMC::filter(int id, int mask) {
+    rxMessage.can_id = (uint32_t)id & CAN_STANDARD_ID_MASK;
+    rxMessage.can_id_mask = (uint32_t)mask & CAN_STANDARD_ID_MASK;
+    rxMessage.can_id_mode = XMC_CAN_FRAME_TYPE_STANDARD_11BITS;
+    rxMessage.can_ide_mask = 1U;
+    return 1;
+}
+
+int CANXMC::filterExtended(long id, long mask) {
+    rxMessage.can_id = (uint32_t)id & CAN_EXTENDED_ID_MASK;
+    rxMessage.can_id_mask = (uint32_t)mask & CAN_EXTENDED_ID_MASK;
+    rxMessage.can_id_mode = XMC_CAN_FRAME_TYPE_EXTENDED_29BITS;
+    rxMessage.can_ide_mask = 1U;
+    return 1;
+}
+
+// Listen only mode is not supported, matching the XMC library
+int CANXMC::observe() { return 0; }
+
+int CANXMC::loopback() {
+    loopbackMode = true;
+    return 1;
+}
+
+int CANXMC::sleep() { return 0; }
+
+int CANXMC::wakeup() { return 0; }
+
+#if defined(__linux__)
+
+void CANXMC::bridgeOpen() {
+    const char *interface_name = getenv("HOST_CAN_INTERFACE");
+    if (interface_name == nullptr || bridgeSocket >= 0) {
+        return;
+    }
+
+    int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) {
+        fprintf(stderr, "host CAN: cannot open SocketCAN socket\n");
+        return;
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, interface_name, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        fprintf(stderr, "host CAN: interface %s not found\n", interface_name);
+        close(fd);
+        return;
+    }
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "host CAN: cannot bind to %s\n", interface_name);
+        close(fd);
+        return;
+    }
+
+    bridgeSocket = fd;
+    bridgeRunning = true;
+    bridgeThread = new std::thread(&CANXMC::bridgeReceiveTask, this);
+}
+
+void CANXMC::bridgeClose() {
+    if (bridgeSocket < 0) {
+        return;
+    }
+
+    bridgeRunning = false;
+    std::thread *thread = (std::thread *)bridgeThread;
+    thread->join();
+    delete thread;
+    bridgeThread = nullptr;
+
+    close(bridgeSocket);
+    bridgeSocket = -1;
+}
+
+void CANXMC::bridgeSend(const HostCanFrame &frame) {
+    if (bridgeSocket < 0) {
+        return;
+    }
+
+    struct can_frame raw;
+    memset(&raw, 0, sizeof(raw));
+    raw.can_id = frame.id;
+    if (frame.extended) {
+        raw.can_id |= CAN_EFF_FLAG;
+    }
+    if (frame.rtr) {
+        raw.can_id |= CAN_RTR_FLAG;
+    }
+    raw.can_dlc = frame.dlc;
+    memcpy(raw.data, frame.data, frame.dlc);
+
+    if (::write(bridgeSocket, &raw, sizeof(raw)) != (ssize_t)sizeof(raw)) {
+        fprintf(stderr, "host CAN: frame 0x%lx not sent\n", (unsigned long)frame.id);
+    }
+}
+
+/**
+ * @brief Emulates the receive interrupt: frames read from the interface are passed
+ *        to all local nodes of the virtual bus.
+ */
+void CANXMC::bridgeReceiveTask() {
+    struct pollfd pfd;
+    pfd.fd = bridgeSocket;
+    pfd.events = POLLIN;
+
+    while (bridgeRunning) {
+        if (poll(&pfd, 1, 10) <= 0) {
+            continue;
+        }
+
+        struct can_frame raw;
+        if (::read(bridgeSocket, &raw, sizeof(raw)) != (ssize_t)sizeof(raw)) {
+            continue;
+        }
+
+        HostCanFrame frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.extended = (raw.can_id & CAN_EFF_FLAG) != 0;
+        frame.rtr = (raw.can_id & CAN_RTR_FLAG) != 0;
+        frame.id = raw.can_id & (frame.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+        frame.dlc = raw.can_dlc > CAN_MAX_DATA_LENGTH ? CAN_MAX_DATA_LENGTH : raw.can_dlc;
+        memcpy(frame.data, raw.data, frame.dlc);
+
+        hostInterruptEnter();
+        hostCanBus.deliver(nullptr, frame);
+        hostInterruptExit();
+    }
+}
+
+#else
+
+void CANXMC::bridgeOpen() {}
+
+void CANXMC::bridgeClose() {}
+
+void CANXMC::bridgeSend(const HostCanFrame &frame) { (void)frame; }
+
+void CANXMC::bridgeReceiveTask() {}
+
+#endif // __linux__
@@ -0,0 +1,24 @@
+// Arduino includes
+#include <Arduino.h>
+
+// test includes
+#include "unity_fixture.h"
+
+/**
+ * Entry point of the host test executables.
+ *
+ * Instead of running the test groups forever from loop(), as on the boards, the test
+ * groups selected by the test flags run once and the Unity result is returned as the
+ * process exit code. Command line arguments are passed on to Unity (e.g. "-v").
+ */
+
+void RunAllTests(void);
+
+int main(int argc, const char *argv[]) {
+    setup();
+
+    int failures = UnityMain(argc, argv, RunAllTests);
+
+    Serial.flush();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,549 @@
+// std includes
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Arduino includes
+#include <Arduino.h>
+#include <WiFi.h>
+
+WiFiClass WiFi;
+
+#define HOST_WIFI_JOIN_POLL_MS      10
+#define HOST_WIFI_RSSI              (-30)
+
+typedef struct {
+    long pid;
+    int32_t channel;
+    IPAddress ip;
+    char passphrase[HOST_WIFI_PASSPHRASE_MAX_LENGTH + 1];
+} host_ap_record_t;
+
+static std::thread scan_thread;
+
+uint32_t hostWifiToLoopback(const IPAddress &ip) {
+    if (ip[0] >= 224 && ip[0] < 240) {
+        return ntohl((uint32_t)ip);
+    }
+    return (127UL << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+}
+
+IPAddress hostWifiFromLoopback(uint32_t address) {
+    IPAddress ip(htonl(address));
+    if (ip[0] == 127) {
+        // The first octet is not carried by the loopback address, use the one of the local network
+        uint8_t network = WiFi.localIP()[0];
+        ip[0] = network != 0 ? network : 192;
+    }
+    return ip;
+}
+
+uint16_t hostWifiToLoopbackPort(uint16_t port) {
+    if (port != 0 && port < 1024) {
+        return port + HOST_WIFI_PRIVILEGED_PORT_OFFSET;
+    }
+    return port;
+}
+
+uint16_t hostWifiFromLoopbackPort(uint16_t port) {
+    if (port >= HOST_WIFI_PRIVILEGED_PORT_OFFSET && port < HOST_WIFI_PRIVILEGED_PORT_OFFSET + 1024) {
+        return port - HOST_WIFI_PRIVILEGED_PORT_OFFSET;
+    }
+    return port;
+}
+
+static const char *registry_dir() {
+    const char *dir = getenv("HOST_WIFI_DIR");
+    return (dir != nullptr && dir[0] != '\0') ? dir : HOST_WIFI_DEFAULT_DIR;
+}
+
+/**
+ * @brief Directory of an SSID in the registry, created if missing.
+ */
+static void ssid_dir(const char *ssid, char *path, size_t size) {
+    char name[HOST_WIFI_SSID_MAX_LENGTH + 1];
+    size_t i = 0;
+    for (; ssid[i] != '\0' && i < HOST_WIFI_SSID_MAX_LENGTH; i++) {
+        name[i] = (ssid[i] == '/' || ssid[i] == '.') ? '_' : ssid[i];
+    }
+    name[i] = '\0';
+
+    mkdir(registry_dir(), 0777);
+    snprintf(path, size, "%s/%s", registry_dir(), name);
+    mkdir(path, 0777);
+}
+
+static bool process_alive(long pid) { return pid > 0 && (kill((pid_t)pid, 0) == 0 || errno == EPERM); }
+
+static bool read_ap_record(const char *dir, host_ap_record_t &record) {
+    char path[320];
+    snprintf(path, sizeof(path), "%s/ap", dir);
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    unsigned int ip[4];
+    record.passphrase[0] = '\0';
+    int fields = fscanf(file, "%ld %d %u.%u.%u.%u %64s", &record.pid, &record.channel, &ip[0], &ip[1], &ip[2],
+                        &ip[3], record.passphrase);
+    fclose(file);
+    if (fields < 6 || !process_alive(record.pid)) {
+        return false;
+    }
+    record.ip = IPAddress(ip[0], ip[1], ip[2], ip[3]);
+    return true;
+}
+
+/**
+ * @brief Take the lease of an address for this process.
+ *
+ * @return true if the address was free or its lease belonged to a dead process.
+ */
+static bool take_lease(const char *dir, const IPAddress &ip, char *path, size_t size) {
+    snprintf(path, size, "%s/sta_%s", dir, ip.toString().c_str());
+
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        int fd = open(path, O_CREAT | O_EXCL | O_WRONLY, 0666);
+        if (fd >= 0) {
+            char pid[24];
+            int length = snprintf(pid, sizeof(pid), "%ld\n", (long)getpid());
+            bool written = write(fd, pid, length) == length;
+            close(fd);
+            return written;
+        }
+
+        FILE *file = fopen(path, "r");
+        long pid = 0;
+        if (file != nullptr) {
+            if (fscanf(file, "%ld", &pid) != 1) {
+                pid = 0;
+            }
+            fclose(file);
+        }
+        if (process_alive(pid)) {
+            return false;
+        }
+        unlink(path);
+    }
+    return false;
+}
+
+static uint8_t count_leases(const char *dir) {
+    uint8_t count = 0;
+    DIR *entries = opendir(dir);
+    if (entries == nullptr) {
+        return 0;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(entries)) != nullptr) {
+        // Names longer than a lease are not written by take_lease()
+        if (strncmp(entry->d_name, "sta_", 4) != 0 || strlen(entry->d_name) > sizeof("sta_255.255.255.255") - 1) {
+            continue;
+        }
+        char path[320];
+        int length = snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        if (length < 0 || (size_t)length >= sizeof(path)) {
+            continue;
+        }
+        FILE *file = fopen(path, "r");
+        long pid = 0;
+        if (file != nullptr) {
+            if (fscanf(file, "%ld", &pid) != 1) {
+                pid = 0;
+            }
+            fclose(file);
+        }
+        if (process_alive(pid)) {
+            count++;
+        }
+    }
+    closedir(entries);
+    return count;
+}
+
+static void bssid_of(const IPAddress &ip, uint8_t *bssid) {
+    bssid[0] = 0x02;
+    bssid[1] = 0x00;
+    for (uint8_t i = 0; i < 4; i++) {
+        bssid[2 + i] = ip[i];
+    }
+}
+
+WiFiClass::WiFiClass()
+    : mode(MODE_NONE), wifiStatus(WIFI_STATUS_UNINITED), reason(WIFI_ERROR_NONE),
+      timeoutMs(HOST_WIFI_DEFAULT_TIMEOUT_MS), currentBssid{0}, currentChannel(0), joining(false),
+      joinStart(0), staticConfig(false), scanCount(WIFI_SCAN_FAILED) {
+    currentSsid[0] = '\0';
+    currentPassphrase[0] = '\0';
+    leasePath[0] = '\0';
+}
+
+void WiFiClass::applyConfig(const IPAddress &default_ip, const IPAddress &default_gateway) {
+    if (staticConfig) {
+        localAddress = staticLocal;
+        gatewayAddress = staticGateway;
+        subnetAddress = staticSubnet;
+        dnsAddress[0] = staticDns;
+    } else {
+        localAddress = default_ip;
+        gatewayAddress = default_gateway;
+        subnetAddress = IPAddress(255, 255, 255, 0);
+        dnsAddress[0] = default_gateway;
+    }
+}
+
+bool WiFiClass::tryJoin() {
+    char dir[300];
+    host_ap_record_t ap;
+
+    ssid_dir(currentSsid, dir, sizeof(dir));
+    if (!read_ap_record(dir, ap) || strcmp(ap.passphrase, currentPassphrase) != 0) {
+        return false;
+    }
+
+    if (staticConfig) {
+        if (!take_lease(dir, staticLocal, leasePath, sizeof(leasePath))) {
+            return false;
+        }
+        applyConfig(staticLocal, ap.ip);
+    } else {
+        // DHCP: the lowest free address above the access point
+        bool leased = false;
+        for (uint16_t host = ap.ip[3] + 1; host < 255 && !leased; host++) {
+            IPAddress ip(ap.ip[0], ap.ip[1], ap.ip[2], (uint8_t)host);
+            if (take_lease(dir, ip, leasePath, sizeof(leasePath))) {
+                applyConfig(ip, ap.ip);
+                leased = true;
+            }
+        }
+        if (!leased) {
+            return false;
+        }
+    }
+
+    bssid_of(ap.ip, currentBssid);
+    currentChannel = ap.channel;
+    wifiStatus = WL_CONNECTED;
+    reason = WIFI_ERROR_NONE;
+    return true;
+}
+
+void WiFiClass::leave() {
+    if (leasePath[0] != '\0') {
+        unlink(leasePath);
+        leasePath[0] = '\0';
+    }
+    if (mode == MODE_AP) {
+        char dir[300];
+        char path[320];
+        ssid_dir(currentSsid, dir, sizeof(dir));
+        snprintf(path, sizeof(path), "%s/ap", dir);
+        unlink(path);
+    }
+    joining = false;
+    localAddress = IPAddress();
+}
+
+int WiFiClass::begin(const char *ssid, const char *passphrase) {
+    if (beginAsync(ssid, passphrase) == 0) {
+        return WIFI_ERROR_STA_CONNECT_FAILED;
+    }
+    while (status() == WL_IDLE_STATUS) {
+        delay(HOST_WIFI_JOIN_POLL_MS);
+    }
+    return wifiStatus == WL_CONNECTED ? (int)WL_CONNECTED : (int)WIFI_ERROR_STA_CONNECT_FAILED;
+}
+
+int WiFiClass::beginAsync(const char *ssid, const char *passphrase) {
+    if (ssid == nullptr || strlen(ssid) > HOST_WIFI_SSID_MAX_LENGTH ||
+        (passphrase != nullptr && strlen(passphrase) > HOST_WIFI_PASSPHRASE_MAX_LENGTH)) {
+        return 0;
+    }
+    leave();
+
+    mode = MODE_STA;
+    strcpy(currentSsid, ssid);
+    strcpy(currentPassphrase, passphrase != nullptr ? passphrase : "");
+    wifiStatus = WL_IDLE_STATUS;
+    joining = true;
+    joinStart = millis();
+    return 1;
+}
+
+int WiFiClass::beginAP(const char *ssid, const char *passphrase, uint8_t channel) {
+    if (ssid == nullptr || strlen(ssid) > HOST_WIFI_SSID_MAX_LENGTH ||
+        (passphrase != nullptr && strlen(passphrase) > HOST_WIFI_PASSPHRASE_MAX_LENGTH)) {
+        reason = WIFI_ERROR_AP_CONNECT_FAILED;
+        return WL_AP_FAILED;
+    }
+    leave();
+
+    mode = MODE_AP;
+    strcpy(currentSsid, ssid);
+    strcpy(currentPassphrase, passphrase != nullptr ? passphrase : "");
+    currentChannel = channel;
+    applyConfig(IPAddress(192, 168, 0, 1), IPAddress(192, 168, 0, 1));
+    bssid_of(localAddress, currentBssid);
+
+    char dir[300];
+    char path[320];
+    ssid_dir(ssid, dir, sizeof(dir));
+    snprintf(path, sizeof(path), "%s/ap", dir);
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        reason = WIFI_ERROR_AP_CONNECT_FAILED;
+        return WL_AP_FAILED;
+    }
+    fprintf(file, "%ld %d %s %s\n", (long)getpid(), (int)channel, localAddress.toString().c_str(),
+            currentPassphrase);
+    fclose(file);
+
+    wifiStatus = WL_AP_LISTENING;
+    reason = WIFI_ERROR_NONE;
+    return WL_AP_LISTENING;
+}
+
+void WiFiClass::config(IPAddress local_ip) {
+    config(local_ip, IPAddress(local_ip[0], local_ip[1], local_ip[2], 1));
+}
+
+void WiFiClass::config(IPAddress local_ip, IPAddress dns_server) {
+    config(local_ip, dns_server, IPAddress(local_ip[0], local_ip[1], local_ip[2], 1));
+}
+
+void WiFiClass::config(IPAddress local_ip, IPAddress dns_server, IPAddress gateway) {
+    config(local_ip, dns_server, gateway, IPAddress(255, 255, 255, 0));
+}
+
+void WiFiClass::config(IPAddress local_ip, IPAddress dns_server, IPAddress gateway, IPAddress subnet) {
+    staticConfig = true;
+    staticLocal = local_ip;
+    staticDns = dns_server;
+    staticGateway = gateway;
+    staticSubnet = subnet;
+}
+
+void WiFiClass::setDNS(IPAddress dns_server1) { dnsAddress[0] = dns_server1; }
+
+void WiFiClass::setDNS(IPAddress dns_server1, IPAddress dns_server2) {
+    dnsAddress[0] = dns_server1;
+    dnsAddress[1] = dns_server2;
+}
+
+void WiFiClass::disconnect() {
+    if (mode == MODE_NONE) {
+        return;
+    }
+    if (mode == MODE_STA && wifiStatus == WL_CONNECTED) {
+        delay(HOST_WIFI_DEAUTH_MS);
+    }
+    leave();
+    wifiStatus = mode == MODE_AP ? WIFI_STATUS_AP_DISCONNECTED : WIFI_STATUS_STA_DISCONNECTED;
+}
+
+void WiFiClass::end() {
+    leave();
+    scanDelete();
+    mode = MODE_NONE;
+    staticConfig = false;
+    wifiStatus = WIFI_STATUS_UNINITED;
+}
+
+uint8_t WiFiClass::status() {
+    if (joining) {
+        if (tryJoin()) {
+            joining = false;
+        } else if ((millis() - joinStart) >= timeoutMs) {
+            joining = false;
+            wifiStatus = WIFI_STATUS_STA_DISCONNECTED;
+            reason = WIFI_ERROR_STA_CONNECT_FAILED;
+        }
+    }
+    return wifiStatus;
+}
+
+uint8_t WiFiClass::connected() {
+    if (mode == MODE_AP && wifiStatus == WL_AP_LISTENING) {
+        char dir[300];
+        ssid_dir(currentSsid, dir, sizeof(dir));
+        return count_leases(dir);
+    }
+    return status() == WL_CONNECTED ? 1 : 0;
+}
+
+void WiFiClass::scanInto(scan_result_t *results, int8_t &count) {
+    count = 0;
+    DIR *entries = opendir(registry_dir());
+    if (entries == nullptr) {
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(entries)) != nullptr && count < HOST_WIFI_MAX_SCAN_RESULTS) {
+        // Names longer than an SSID are not written by ssid_dir()
+        if (entry->d_name[0] == '.' || strlen(entry->d_name) > HOST_WIFI_SSID_MAX_LENGTH) {
+            continue;
+        }
+        char dir[300];
+        host_ap_record_t ap;
+        int length = snprintf(dir, sizeof(dir), "%s/%s", registry_dir(), entry->d_name);
+        if (length < 0 || (size_t)length >= sizeof(dir) || !read_ap_record(dir, ap)) {
+            continue;
+        }
+
+        scan_result_t &result = results[count++];
+        strcpy(result.ssid, entry->d_name);
+        bssid_of(ap.ip, result.bssid);
+        result.channel = ap.channel;
+    }
+    closedir(entries);
+}
+
+int8_t WiFiClass::scanNetworks() {
+    scanDelete();
+    // A real scan dwells on every channel, the registry is read at once
+    delay(HOST_WIFI_SCAN_MS);
+    int8_t count;
+    scanInto(scanResults, count);
+    scanCount = count;
+    return count;
+}
+
+int8_t WiFiClass::scanNetworks(bool async) {
+    if (!async) {
+        return scanNetworks();
+    }
+    scanDelete();
+    scanCount = WIFI_SCAN_RUNNING;
+    scan_thread = std::thread([this]() {
+        delay(HOST_WIFI_SCAN_MS);
+        int8_t count;
+        scanInto(scanResults, count);
+        std::atomic_thread_fence(std::memory_order_release);
+        scanCount = count;
+    });
+    return WIFI_SCAN_RUNNING;
+}
+
+int8_t WiFiClass::scanComplete() {
+    int8_t count = scanCount;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return count;
+}
+
+void WiFiClass::scanDelete() {
+    if (scan_thread.joinable()) {
+        scan_thread.join();
+    }
+    scanCount = WIFI_SCAN_FAILED;
+}
+
+const WiFiClass::scan_result_t *WiFiClass::scanResult(uint8_t index) {
+    int8_t count = scanComplete();
+    if (count <= 0 || index >= count) {
+        return nullptr;
+    }
+    return &scanResults[index];
+}
+
+const char *WiFiClass::SSID() { return currentSsid; }
+
+const char *WiFiClass::SSID(uint8_t index) {
+    const scan_result_t *result = scanResult(index);
+    return result != nullptr ? result->ssid : "";
+}
+
+uint8_t *WiFiClass::BSSID(uint8_t *bssid) {
+    memcpy(bssid, currentBssid, sizeof(currentBssid));
+    return bssid;
+}
+
+uint8_t *WiFiClass::BSSID(uint8_t index, uint8_t *bssid) {
+    const scan_result_t *result = scanResult(index);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    memcpy(bssid, result->bssid, sizeof(result->bssid));
+    return bssid;
+}
+
+int32_t WiFiClass::RSSI() { return wifiStatus == WL_CONNECTED ? HOST_WIFI_RSSI : INT32_MIN; }
+
+int32_t WiFiClass::RSSI(uint8_t index) { return scanResult(index) != nullptr ? HOST_WIFI_RSSI : INT32_MIN; }
+
+uint8_t WiFiClass::encryptionType() { return currentPassphrase[0] != '\0' ? AUTH_MODE_WPA2 : AUTH_MODE_OPEN; }
+
+uint8_t WiFiClass::encryptionType(uint8_t index) {
+    const scan_result_t *result = scanResult(index);
+    if (result == nullptr) {
+        return AUTH_MODE_OPEN;
+    }
+    char dir[300];
+    host_ap_record_t ap;
+    snprintf(dir, sizeof(dir), "%s/%s", registry_dir(), result->ssid);
+    return (read_ap_record(dir, ap) && ap.passphrase[0] == '\0') ? AUTH_MODE_OPEN : AUTH_MODE_WPA2;
+}
+
+int32_t WiFiClass::channel() { return currentChannel; }
+
+int32_t WiFiClass::channel(uint8_t index) {
+    const scan_result_t *result = scanResult(index);
+    return result != nullptr ? result->channel : 0;
+}
+
+uint8_t *WiFiClass::macAddress(uint8_t *mac) {
+    uint32_t pid = (uint32_t)getpid();
+    mac[0] = 0x02;
+    mac[1] = 0x01;
+    for (uint8_t i = 0; i < 4; i++) {
+        mac[2 + i] = (uint8_t)(pid >> (24 - 8 * i));
+    }
+    return mac;
+}
+
+int WiFiClass::hostByName(const char *hostname, IPAddress &result) {
+    // No name service on the virtual network, only dotted addresses resolve
+    struct in_addr address;
+    if (hostname == nullptr || inet_pton(AF_INET, hostname, &address) != 1) {
+        reason = WIFI_ERROR_DNS_FAILED;
+        return 0;
+    }
+    result = IPAddress((uint32_t)address.s_addr);
+    return 1;
+}
+
+int WiFiClass::ping(const char *hostname, uint8_t ttl) {
+    IPAddress host;
+    if (!hostByName(hostname, host)) {
+        reason = WIFI_ERROR_PING_FAILED;
+        return WIFI_ERROR_PING_FAILED;
+    }
+    return ping(host, ttl);
+}
+
+int WiFiClass::ping(IPAddress host, uint8_t ttl) {
+    (void)ttl;
+    bool reachable = false;
+
+    if (wifiStatus == WL_CONNECTED || wifiStatus == WL_AP_LISTENING) {
+        char dir[300];
+        char path[320];
+        ssid_dir(currentSsid, dir, sizeof(dir));
+        snprintf(path, sizeof(path), "%s/sta_%s", dir, host.toString().c_str());
+        reachable = host == localAddress || host == gatewayAddress || access(path, F_OK) == 0;
+    }
+    reason = reachable ? WIFI_ERROR_NONE : WIFI_ERROR_PING_FAILED;
+    return reason;
+}
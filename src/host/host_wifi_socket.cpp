@@ -0,0 +1,627 @@
+// std includes
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Arduino includes
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <WiFiServer.h>
+#include <WiFiUdp.h>
+
+#define HOST_WIFI_LISTEN_BACKLOG        64
+#define HOST_WIFI_NOTIFY_PERIOD_US      200
+
+struct WiFiClient::Connection {
+    int fd = -1;
+    uint8_t status = SOCKET_STATUS_UNINITED;
+    bool connecting = false;
+    bool nodelay = false;
+    IPAddress remoteIP;
+    uint16_t remotePort = 0;
+
+    /* Shared with the receive notification thread */
+    std::mutex lock;
+    void (*callback)(void *arg) = nullptr;
+    void *callbackArg = nullptr;
+    uint64_t consumed = 0;
+    uint64_t notified = 0;
+
+    ~Connection() { close(); }
+
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        connecting = false;
+        if (status != SOCKET_STATUS_UNINITED) {
+            status = SOCKET_STATUS_DELETED;
+        }
+    }
+
+    /**
+     * @brief Complete a pending connect and detect a connection closed by the peer.
+     */
+    void update() {
+        if (connecting) {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            if (poll(&pfd, 1, 0) <= 0) {
+                return;
+            }
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0) {
+                close();
+                return;
+            }
+            connecting = false;
+            status = SOCKET_STATUS_CONNECTED;
+        }
+        if (status == SOCKET_STATUS_CONNECTED) {
+            uint8_t c;
+            ssize_t result = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+            if (result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                close();
+            }
+        }
+    }
+
+    int pending() const {
+        int count = 0;
+        if (fd < 0 || ioctl(fd, FIONREAD, &count) != 0) {
+            return 0;
+        }
+        return count;
+    }
+
+    void consume(size_t count) {
+        std::lock_guard<std::mutex> guard(lock);
+        consumed += count;
+    }
+};
+
+/**
+ * @brief Emulated network stack invoking the onReceive() callbacks of the clients.
+ *
+ * @details The amount of data received by a client is the data it consumed plus the
+ * data pending in its socket. A callback is invoked whenever it grows.
+ */
+static std::mutex receivers_lock;
+static std::vector<std::weak_ptr<WiFiClient::Connection>> receivers;
+static bool receiver_thread_started = false;
+
+static void receiver_thread() {
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::microseconds(HOST_WIFI_NOTIFY_PERIOD_US));
+
+        std::vector<std::shared_ptr<WiFiClient::Connection>> connections;
+        {
+            std::lock_guard<std::mutex> guard(receivers_lock);
+            for (size_t i = 0; i < receivers.size();) {
+                std::shared_ptr<WiFiClient::Connection> connection = receivers[i].lock();
+                if (connection) {
+                    connections.push_back(connection);
+                    i++;
+                } else {
+                    receivers.erase(receivers.begin() + i);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < connections.size(); i++) {
+            WiFiClient::Connection &connection = *connections[i];
+            void (*callback)(void *arg) = nullptr;
+            void *arg = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(connection.lock);
+                uint64_t received = connection.consumed + connection.pending();
+                if (connection.callback != nullptr && received > connection.notified) {
+                    connection.notified = received;
+                    callback = connection.callback;
+                    arg = connection.callbackArg;
+                }
+            }
+            if (callback != nullptr) {
+                hostInterruptEnter();
+                callback(arg);
+                hostInterruptExit();
+            }
+        }
+    }
+}
+
+static void register_receiver(const std::shared_ptr<WiFiClient::Connection> &connection) {
+    std::lock_guard<std::mutex> guard(receivers_lock);
+    receivers.push_back(connection);
+    if (!receiver_thread_started) {
+        receiver_thread_started = true;
+        std::thread(receiver_thread).detach();
+    }
+}
+
+static struct sockaddr_in loopback_address(const IPAddress &ip, uint16_t port) {
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(hostWifiToLoopback(ip));
+    address.sin_port = htons(hostWifiToLoopbackPort(port));
+    return address;
+}
+
+/**
+ * @brief Loopback address of the local IP, or 127.0.0.1 without a network.
+ */
+static struct sockaddr_in local_address(uint16_t port) {
+    IPAddress ip = WiFi.localIP();
+    if (ip == IPAddress()) {
+        ip = IPAddress(127, 0, 0, 1);
+    }
+    return loopback_address(ip, port);
+}
+
+static void set_nonblocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+/* WiFiClient */
+
+WiFiClient::WiFiClient() : conn(std::make_shared<Connection>()) {}
+
+WiFiClient::WiFiClient(const std::shared_ptr<Connection> &connection) : conn(connection) {}
+
+static int start_connect(WiFiClient::Connection &connection, IPAddress ip, uint16_t port, bool async) {
+    connection.close();
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct sockaddr_in local = local_address(0);
+    struct sockaddr_in remote = loopback_address(ip, port);
+    if (bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        ::close(fd);
+        return 0;
+    }
+    int nodelay = connection.nodelay ? 1 : 0;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    if (async) {
+        set_nonblocking(fd);
+    }
+
+    int result = connect(fd, (struct sockaddr *)&remote, sizeof(remote));
+    if (result != 0 && !(async && errno == EINPROGRESS)) {
+        ::close(fd);
+        return 0;
+    }
+    if (!async) {
+        set_nonblocking(fd);
+    }
+
+    std::lock_guard<std::mutex> guard(connection.lock);
+    connection.fd = fd;
+    connection.remoteIP = ip;
+    connection.remotePort = port;
+    connection.consumed = 0;
+    connection.notified = 0;
+    connection.connecting = result != 0;
+    connection.status = result != 0 ? SOCKET_STATUS_CREATED : SOCKET_STATUS_CONNECTED;
+    return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) { return start_connect(*conn, ip, port, false); }
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) {
+        return 0;
+    }
+    return connect(ip, port);
+}
+
+int WiFiClient::connectAsync(IPAddress ip, uint16_t port) { return start_connect(*conn, ip, port, true); }
+
+void WiFiClient::onReceive(void (*callback)(void *arg), void *arg) {
+    {
+        std::lock_guard<std::mutex> guard(conn->lock);
+        conn->callback = callback;
+        conn->callbackArg = arg;
+    }
+    register_receiver(conn);
+}
+
+void WiFiClient::setNoDelay(bool nodelay) {
+    conn->nodelay = nodelay;
+    if (conn->fd >= 0) {
+        int value = nodelay ? 1 : 0;
+        setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+    }
+}
+
+bool WiFiClient::getNoDelay() { return conn->nodelay; }
+
+size_t WiFiClient::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+
+    conn->update();
+    if (conn->status != SOCKET_STATUS_CONNECTED) {
+        return 0;
+    }
+    // Block until everything is queued, as the core does
+    while (written < size) {
+        ssize_t result = send(conn->fd, buffer + written, size - written, MSG_NOSIGNAL);
+        if (result > 0) {
+            written += result;
+        } else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = {conn->fd, POLLOUT, 0};
+            poll(&pfd, 1, 10);
+        } else {
+            break;
+        }
+    }
+    return written;
+}
+
+int WiFiClient::available() {
+    conn->update();
+    return conn->pending();
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+    if (conn->fd < 0 || size == 0) {
+        return -1;
+    }
+    ssize_t result = recv(conn->fd, buffer, size, MSG_DONTWAIT);
+    if (result <= 0) {
+        return -1;
+    }
+    conn->consume(result);
+    return (int)result;
+}
+
+int WiFiClient::peek() {
+    uint8_t c;
+    if (conn->fd < 0 || recv(conn->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) != 1) {
+        return -1;
+    }
+    return c;
+}
+
+void WiFiClient::flush() {
+    uint8_t discard[256];
+    // The core discards the unread data
+    while (read(discard, sizeof(discard)) > 0) {
+    }
+}
+
+void WiFiClient::stop() { conn->close(); }
+
+uint8_t WiFiClient::connected() {
+    conn->update();
+    return conn->status == SOCKET_STATUS_CONNECTED ? 1 : 0;
+}
+
+uint8_t WiFiClient::status() {
+    conn->update();
+    return conn->status;
+}
+
+IPAddress WiFiClient::remoteIP() { return conn->remoteIP; }
+
+uint16_t WiFiClient::remotePort() { return conn->remotePort; }
+
+/* WiFiServer */
+
+WiFiServer::WiFiServer(uint16_t port)
+    : serverPort(port), fd(-1), serverStatus(SOCKET_STATUS_UNINITED), nextClient(0) {}
+
+WiFiServer::~WiFiServer() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+void WiFiServer::begin() { begin(serverPort); }
+
+void WiFiServer::begin(uint16_t port) {
+    end();
+    serverPort = port;
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in local = local_address(port);
+    if (bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0 || listen(fd, HOST_WIFI_LISTEN_BACKLOG) != 0) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    serverStatus = SOCKET_STATUS_LISTENING;
+}
+
+void WiFiServer::end() {
+    for (size_t i = 0; i < clients.size(); i++) {
+        clients[i]->close();
+    }
+    clients.clear();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+        serverStatus = SOCKET_STATUS_DELETED;
+    }
+}
+
+void WiFiServer::acceptPending() {
+    if (fd < 0) {
+        return;
+    }
+    while (true) {
+        struct sockaddr_in remote;
+        socklen_t length = sizeof(remote);
+        int client_fd = accept4(fd, (struct sockaddr *)&remote, &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            return;
+        }
+        std::shared_ptr<WiFiClient::Connection> connection = std::make_shared<WiFiClient::Connection>();
+        connection->fd = client_fd;
+        connection->status = SOCKET_STATUS_CONNECTED;
+        connection->remoteIP = hostWifiFromLoopback(ntohl(remote.sin_addr.s_addr));
+        // The core reports the server port for accepted clients
+        connection->remotePort = serverPort;
+        clients.push_back(connection);
+    }
+}
+
+void WiFiServer::prune() {
+    for (size_t i = 0; i < clients.size();) {
+        clients[i]->update();
+        if (clients[i]->status != SOCKET_STATUS_CONNECTED) {
+            clients.erase(clients.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    if (clients.empty()) {
+        // Release the client slots, as the core does
+        std::vector<std::shared_ptr<WiFiClient::Connection>>().swap(clients);
+    }
+}
+
+WiFiClient WiFiServer::available() {
+    acceptPending();
+    prune();
+    for (size_t i = 0; i < clients.size(); i++) {
+        size_t index = (nextClient + i) % clients.size();
+        if (clients[index]->pending() > 0) {
+            nextClient = index + 1;
+            return WiFiClient(clients[index]);
+        }
+    }
+    return WiFiClient();
+}
+
+uint8_t WiFiServer::connectedSize() {
+    acceptPending();
+    prune();
+    return (uint8_t)clients.size();
+}
+
+size_t WiFiServer::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiServer::write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+
+    acceptPending();
+    prune();
+    for (size_t i = 0; i < clients.size(); i++) {
+        size_t result = WiFiClient(clients[i]).write(buffer, size);
+        if (result > written) {
+            written = result;
+        }
+    }
+    return written;
+}
+
+/* WiFiUDP */
+
+WiFiUDP::WiFiUDP()
+    : fd(-1), multicastFd(-1), localPort(0), txPort(0), txLength(0), remotePortNumber(0), rxLength(0),
+      rxPosition(0) {}
+
+WiFiUDP::~WiFiUDP() { stop(); }
+
+bool WiFiUDP::bindSocket(int &socket_fd, uint32_t address, uint16_t port) {
+    socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (socket_fd < 0) {
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Multicast is sent and looped back on the loopback interface
+    struct ip_mreqn multicast_if;
+    memset(&multicast_if, 0, sizeof(multicast_if));
+    multicast_if.imr_ifindex = if_nametoindex("lo");
+    setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_IF, &multicast_if, sizeof(multicast_if));
+    unsigned char loop = 1;
+    setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(address);
+    local.sin_port = htons(hostWifiToLoopbackPort(port));
+    if (bind(socket_fd, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        ::close(socket_fd);
+        socket_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+
+    struct sockaddr_in local = local_address(port);
+    if (!bindSocket(fd, ntohl(local.sin_addr.s_addr), port)) {
+        return SOCKET_STATUS_UNINITED;
+    }
+    localPort = port;
+    boundIP = WiFi.localIP();
+    return SOCKET_STATUS_BOUND;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress ip, uint16_t port) {
+    if (begin(port) != SOCKET_STATUS_BOUND) {
+        return SOCKET_STATUS_UNINITED;
+    }
+    if (!bindSocket(multicastFd, hostWifiToLoopback(ip), port)) {
+        stop();
+        return SOCKET_STATUS_UNINITED;
+    }
+
+    struct ip_mreqn membership;
+    memset(&membership, 0, sizeof(membership));
+    membership.imr_multiaddr.s_addr = (uint32_t)ip;
+    membership.imr_ifindex = if_nametoindex("lo");
+    if (setsockopt(multicastFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        stop();
+        return SOCKET_STATUS_UNINITED;
+    }
+    return SOCKET_STATUS_BOUND;
+}
+
+void WiFiUDP::stop() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    if (multicastFd >= 0) {
+        ::close(multicastFd);
+        multicastFd = -1;
+    }
+    rxLength = 0;
+    rxPosition = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    // The socket follows a new local IP, e.g. after a reconnect with another configuration
+    if (fd < 0 || (WiFi.localIP() != boundIP && WiFi.localIP() != IPAddress())) {
+        int multicast = multicastFd;
+        multicastFd = -1;
+        uint8_t result = begin(localPort);
+        multicastFd = multicast;
+        if (result != SOCKET_STATUS_BOUND) {
+            return 0;
+        }
+    }
+    txAddress = ip;
+    txPort = port;
+    txLength = 0;
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port) {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) {
+        return 0;
+    }
+    return beginPacket(ip, port);
+}
+
+int WiFiUDP::endPacket() {
+    struct sockaddr_in remote = loopback_address(txAddress, txPort);
+    ssize_t result = sendto(fd, txBuffer, txLength, 0, (struct sockaddr *)&remote, sizeof(remote));
+    txLength = 0;
+    return result >= 0 ? 1 : 0;
+}
+
+size_t WiFiUDP::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size) {
+    if (size > sizeof(txBuffer) - txLength) {
+        size = sizeof(txBuffer) - txLength;
+    }
+    memcpy(txBuffer + txLength, buffer, size);
+    txLength += size;
+    return size;
+}
+
+int WiFiUDP::receive(int socket_fd) {
+    if (socket_fd < 0) {
+        return 0;
+    }
+    struct sockaddr_in remote;
+    socklen_t length = sizeof(remote);
+    ssize_t result = recvfrom(socket_fd, rxBuffer, sizeof(rxBuffer), MSG_DONTWAIT, (struct sockaddr *)&remote,
+                              &length);
+    if (result <= 0) {
+        return 0;
+    }
+    rxLength = result;
+    rxPosition = 0;
+    remoteAddress = hostWifiFromLoopback(ntohl(remote.sin_addr.s_addr));
+    remotePortNumber = hostWifiFromLoopbackPort(ntohs(remote.sin_port));
+    return (int)rxLength;
+}
+
+int WiFiUDP::parsePacket() {
+    rxLength = 0;
+    rxPosition = 0;
+    int size = receive(fd);
+    if (size == 0) {
+        size = receive(multicastFd);
+    }
+    return size;
+}
+
+int WiFiUDP::available() { return (int)(rxLength - rxPosition); }
+
+int WiFiUDP::read() { return rxPosition < rxLength ? rxBuffer[rxPosition++] : -1; }
+
+int WiFiUDP::read(unsigned char *buffer, size_t len) {
+    size_t count = rxLength - rxPosition;
+    if (count == 0) {
+        return -1;
+    }
+    if (len < count) {
+        count = len;
+    }
+    memcpy(buffer, rxBuffer + rxPosition, count);
+    rxPosition += count;
+    return (int)count;
+}
+
+int WiFiUDP::peek() { return rxPosition < rxLength ? rxBuffer[rxPosition] : -1; }
+
+void WiFiUDP::flush() { rxPosition = rxLength; }
+
+const uint8_t *WiFiUDP::peekBuffer(size_t &length) {
+    length = rxLength - rxPosition;
+    return length > 0 ? rxBuffer + rxPosition : nullptr;
+}
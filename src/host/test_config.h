@@ -0,0 +1,19 @@
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+/**
+ * @brief Test configuration of the host stand-ins, used by the "host_test_<test_name>"
+ *        make targets instead of the project specific test_config.h of a board.
+ */
+
+// Analog IO, wired to the simulated analog front end (host_analog.cpp)
+#define TEST_PIN_ANALOG_IO_VREF         HOST_PIN_ANALOG_VDDA
+#define TEST_PIN_ANALOG_IO_DIVIDER      HOST_PIN_ANALOG_DIVIDER
+#define TEST_PIN_ANALOG_IO_GND          HOST_PIN_ANALOG_GND
+#define TEST_PIN_ANALOG_IO_DAC          HOST_PIN_DAC
+#define TEST_PIN_ANALOG_IO_DAC_INPUT    HOST_PIN_DAC_INPUT
+
+#define TEST_ADC_RESOLUTION             10
+#define TEST_ADC_MAX_VALUE              1023
+
+#endif // TEST_CONFIG_H
@@ -19,7 +19,8 @@
 
 // Arduino includes
 #include <Arduino.h>
-#if defined(TEST_CAN_SINGLE) || defined(TEST_CAN_CONNECTED2_NODE1) || defined(TEST_CAN_CONNECTED2_NODE2)
+#if defined(TEST_CAN_SINGLE) || defined(TEST_CAN_CONNECTED2_NODE1) || defined(TEST_CAN_CONNECTED2_NODE2) || \
+    defined(TEST_CAN_CONNECTED2_EXTENDED_NODE1) || defined(TEST_CAN_CONNECTED2_EXTENDED_NODE2)
     #include <CAN.h>
 #endif
 
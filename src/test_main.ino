@@ -22,6 +22,12 @@ void RunAllTests(void)
 
 #endif
 
+#ifdef TEST_DIGITALIO_BENCHMARK
+
+    RUN_TEST_GROUP(digitalio_benchmark);
+
+#endif
+
 #ifdef TEST_ANALOGIO_ADC
 
     RUN_TEST_GROUP(analogio_adc);
@@ -40,12 +46,48 @@ void RunAllTests(void)
 
 #endif
 
+#ifdef TEST_ANALOGIO_ADC_BENCHMARK
+
+    RUN_TEST_GROUP(analogio_adc_benchmark);
+
+#endif
+
+#ifdef TEST_ANALOGIO_ADC_SCAN
+
+    RUN_TEST_GROUP(analogio_adc_scan);
+
+#endif
+
+#ifdef TEST_ANALOGIO_DAC_BENCHMARK
+
+    RUN_TEST_GROUP(analogio_dac_benchmark);
+
+#endif
+
+#ifdef TEST_ANALOGIO_PWM_UPDATE
+
+    RUN_TEST_GROUP(analogio_pwm_update);
+
+#endif
+
 #ifdef TEST_INTERRUPTS_SINGLE
 
     RUN_TEST_GROUP(gpio_interrupts_single);
 
 #endif
 
+#ifdef TEST_INTERRUPTS_BENCHMARK
+
+    RUN_TEST_GROUP(gpio_interrupts_benchmark);
+
+#endif
+
+#ifdef TEST_INTERRUPTS_STORM
+
+    RUN_TEST_GROUP(gpio_interrupts_storm);
+
+#endif
+
 #ifdef TEST_UART_CONNECTED2_TX
 
     RUN_TEST_GROUP(uart_connected2_tx);
@@ -92,6 +134,20 @@ void RunAllTests(void)
 
 #endif
 
+// CAN with 2 boards connections node 1, extended and remote frame requester
+#ifdef TEST_CAN_CONNECTED2_EXTENDED_NODE1
+
+    RUN_TEST_GROUP(can_connected2_extended_node1);
+
+#endif
+
+// CAN with 2 boards connections node 2, extended and remote frame responder
+#ifdef TEST_CAN_CONNECTED2_EXTENDED_NODE2
+
+    RUN_TEST_GROUP(can_connected2_extended_node2);
+
+#endif
+
 
 // IIC with connections
 #ifdef TEST_WIRE_CONNECTED1_PINGPONG
@@ -128,6 +184,24 @@ void RunAllTests(void)
 
 #endif
 
+#ifdef TEST_WIFI_STA_RECONNECT
+
+    RUN_TEST_GROUP(wifi_sta_reconnect);
+
+#endif
+
+#ifdef TEST_WIFI_AP_RECONNECT
+
+    RUN_TEST_GROUP(wifi_ap_reconnect);
+
+#endif
+
+#ifdef TEST_WIFI_SCAN
+
+    RUN_TEST_GROUP(wifi_scan);
+
+#endif
+
 #ifdef TEST_WIFI_CLIENT
 
     RUN_TEST_GROUP(wifi_client);
@@ -165,6 +239,102 @@ void RunAllTests(void)
 
 #endif
 
+#ifdef TEST_WIFI_THROUGHPUT_SERVER
+
+    RUN_TEST_GROUP(wifi_throughput_server);
+
+#endif
+
+#ifdef TEST_WIFI_THROUGHPUT_CLIENT
+
+    RUN_TEST_GROUP(wifi_throughput_client);
+
+#endif
+
+#ifdef TEST_WIFI_CONNECTIONS_SERVER
+
+    RUN_TEST_GROUP(wifi_connections_server);
+
+#endif
+
+#ifdef TEST_WIFI_CONNECTIONS_CLIENT
+
+    RUN_TEST_GROUP(wifi_connections_client);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_BENCHMARK_SERVER
+
+    RUN_TEST_GROUP(wifi_udp_benchmark_server);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_BENCHMARK_CLIENT
+
+    RUN_TEST_GROUP(wifi_udp_benchmark_client);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_MULTICAST_RECEIVER
+
+    RUN_TEST_GROUP(wifi_udp_multicast_receiver);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_MULTICAST_SENDER
+
+    RUN_TEST_GROUP(wifi_udp_multicast_sender);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_READ_SERVER
+
+    RUN_TEST_GROUP(wifi_udp_read_server);
+
+#endif
+
+#ifdef TEST_WIFI_UDP_READ_CLIENT
+
+    RUN_TEST_GROUP(wifi_udp_read_client);
+
+#endif
+
+#ifdef TEST_WIFI_ASYNC_SERVER
+
+    RUN_TEST_GROUP(wifi_async_server);
+
+#endif
+
+#ifdef TEST_WIFI_ASYNC_CLIENT
+
+    RUN_TEST_GROUP(wifi_async_client);
+
+#endif
+
+#ifdef TEST_WIFI_COALESCING_SERVER
+
+    RUN_TEST_GROUP(wifi_coalescing_server);
+
+#endif
+
+#ifdef TEST_WIFI_COALESCING_CLIENT
+
+    RUN_TEST_GROUP(wifi_coalescing_client);
+
+#endif
+
+#ifdef TEST_WIFI_AP_LOAD_SERVER
+
+    RUN_TEST_GROUP(wifi_ap_load_server);
+
+#endif
+
+#ifdef TEST_WIFI_AP_LOAD_STATION
+
+    RUN_TEST_GROUP(wifi_ap_load_station);
+
+#endif
+
 #ifdef TEST_SPI_CONNECTED1_LOOPBACK
 
     RUN_TEST_GROUP(spi_connected1_loopback);
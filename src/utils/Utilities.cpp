@@ -1,11 +1,14 @@
 
 // std includes
+#include <malloc.h>
+#include <math.h>
 #include <stdint.h>
 
 // Arduino includes
 #include <Arduino.h>
 
 // project cpp includes
+#include "Utilities.hpp"
 
 void printArray(const char *title, volatile uint8_t *data, uint8_t quantity) {
     Serial.print(title);
@@ -19,3 +22,86 @@ void printArray(const char *title, volatile uint8_t *data, uint8_t quantity) {
     Serial.println("]");
     Serial.flush();
 }
+
+size_t heapUsedBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return (size_t)mallinfo().uordblks;
+#endif
+}
+
+void IdleMeter::calibrate(uint32_t durationMs) {
+    start();
+    uint32_t end = millis() + durationMs;
+    while ((int32_t)(millis() - end) < 0) {
+        work();
+    }
+    uint32_t elapsed = micros() - startUs;
+    baselineRate = elapsed > 0 ? (double)units * MICROSECONDS_PER_SECOND / elapsed : 0.0;
+}
+
+void IdleMeter::start() {
+    units = 0;
+    startUs = micros();
+}
+
+void IdleMeter::work() {
+    volatile uint32_t acc = 0;
+    for (uint8_t i = 0; i < 64; i++) {
+        acc += i;
+    }
+    units++;
+}
+
+double IdleMeter::headroomPercent() const {
+    uint32_t elapsed = micros() - startUs;
+    if (elapsed == 0 || baselineRate <= 0.0) {
+        return 0.0;
+    }
+    return 100.0 * ((double)units * MICROSECONDS_PER_SECOND / elapsed) / baselineRate;
+}
+
+void RunningStats::reset() {
+    samples = 0;
+    average = 0.0;
+    m2 = 0.0;
+    lowest = 0.0;
+    highest = 0.0;
+}
+
+void RunningStats::add(double sample) {
+    if (samples == 0) {
+        lowest = sample;
+        highest = sample;
+    } else {
+        lowest = sample < lowest ? sample : lowest;
+        highest = sample > highest ? sample : highest;
+    }
+
+    samples++;
+    double delta = sample - average;
+    average += delta / samples;
+    m2 += delta * (sample - average);
+}
+
+double RunningStats::variance() const { return samples > 1 ? m2 / (samples - 1) : 0.0; }
+
+double RunningStats::stddev() const { return sqrt(variance()); }
+
+void RunningStats::print(const char *title, const char *unit) const {
+    Serial.print(title);
+    Serial.print(" : n=");
+    Serial.print(samples);
+    Serial.print(" mean=");
+    Serial.print(average, 3);
+    Serial.print(" std=");
+    Serial.print(stddev(), 3);
+    Serial.print(" min=");
+    Serial.print(lowest, 3);
+    Serial.print(" max=");
+    Serial.print(highest, 3);
+    Serial.print(" ");
+    Serial.println(unit);
+    Serial.flush();
+}
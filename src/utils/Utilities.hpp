@@ -2,6 +2,7 @@
 #define UTILITIES_HPP
 
 // std includes
+#include <stddef.h>
 #include <stdint.h>
 
 // project cpp includes
@@ -10,4 +11,67 @@
 #define MICROS_TO_MILLISECONDS(us) ((unsigned long)((double)(us) / (double)MILLISECONDS_PER_SECOND));
 void printArray(const char *title, volatile uint8_t *data, uint8_t quantity);
 
+/**
+ * @brief Bytes currently allocated from the C library heap (malloc).
+ *
+ * Memory the core takes from other pools (e.g. a static RTOS heap) is not included.
+ */
+size_t heapUsedBytes();
+
+/**
+ * @brief Streaming statistics of a series of samples (Welford's algorithm).
+ *
+ * Mean, variance, minimum and maximum are updated with every sample, so long
+ * measurement series need no sample buffer.
+ */
+class RunningStats {
+public:
+    RunningStats() { reset(); }
+
+    void reset();
+    void add(double sample);
+
+    uint32_t count() const { return samples; }
+    double mean() const { return average; }
+    double variance() const;
+    double stddev() const;
+    double minimum() const { return lowest; }
+    double maximum() const { return highest; }
+
+    void print(const char *title, const char *unit) const;
+
+private:
+    uint32_t samples;
+    double average;
+    double m2;
+    double lowest;
+    double highest;
+};
+
+/**
+ * @brief Idle CPU headroom of a polling loop.
+ *
+ * A fixed unit of dummy work is executed at every idle point of the loop. The rate
+ * of completed work units, relative to the rate of an unloaded loop measured by
+ * calibrate(), is the share of CPU time left to the application. It includes the
+ * time spent in API calls as well as in background tasks of the core (e.g. the
+ * network stack) preempting the loop.
+ */
+class IdleMeter {
+public:
+    IdleMeter() : baselineRate(0.0), units(0), startUs(0) {}
+
+    void calibrate(uint32_t durationMs);
+    void start();
+    void work();
+
+    double baseline() const { return baselineRate; }
+    double headroomPercent() const;
+
+private:
+    double baselineRate; // work units per second without load
+    uint32_t units;
+    uint32_t startUs;
+};
+
 #endif // UTILITIES_HPP